@@ -0,0 +1,17 @@
+	.text
+	.globl	main
+main:                                   # 两段空转，各自等待 timer0 到期（summary 级别跳过，与 --vcd 逐条执行的结果须相同）
+	timer_set 0, 3, 200000, @.Lphase2
+.Lspin:
+	jmp @.Lspin                         # 定时器自循环：调度循环在向后跳转处检测空转
+.Lphase2:
+	timer_set 0, 3, 200000, @.Ldone
+	mov %r3, 40
+.Lloop:                                 # 单块循环：r1 数到 40 后寄存器不再变化；--jit 时块已编译并自链接，
+	arith_op %r5, %r3, %r1, 9           # 空转由本机代码链接的向后出口检测
+	arith_op %r6, %r5, %r0, 4
+	arith_op %r1, %r1, %r6, 8
+	jmp @.Lloop
+.Ldone:
+	trigger
+	ret
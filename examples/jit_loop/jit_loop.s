@@ -0,0 +1,16 @@
+	.text
+	.globl	main
+main:                                   # 20x20 嵌套计数循环：内外层块都超过 JIT_HOT_THRESHOLD 次，编译并互相链接
+	mov %r2, 1
+	mov %r3, 20
+	mov %r5, 20
+.Louter:
+	mov %r1, 0
+.Linner:
+	arith_op %r6, %r6, %r2, 8           # r6 累计内层次数（400）
+	arith_op %r1, %r1, %r2, 8
+	jmpc 1, %r1, %r3, @.Linner
+	arith_op %r4, %r4, %r2, 8
+	jmpc 1, %r4, %r5, @.Louter
+	trigger
+	ret
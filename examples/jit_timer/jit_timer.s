@@ -0,0 +1,11 @@
+	.text
+	.globl	main
+main:                                   # 计数循环由 timer0 到期跳出：循环块编译后在本机代码的链接入口检查定时器
+	mov %r2, 1
+	timer_set 0, 3, 100, @.Lexit
+.Lloop:
+	arith_op %r1, %r1, %r2, 8
+	jmp @.Lloop
+.Lexit:
+	trigger
+	ret
@@ -0,0 +1,11 @@
+	.text
+	.globl	main
+main:
+	load %r1, 0x5000        # top.bus64[31:0]，拆分字 0x6000
+	load %r2, 0x5004        # top.bus64[63:32]，拆分字 0x6100
+	load %r3, 0x6000        # top.bus64 拆分字 0 原值
+	load %r4, 0x5104        # top.bus40[39:32]，最高字按位宽截断
+	load %r5, 0x6300        # top.bus40 拆分字 1 原值（不截断）
+	load %r6, 0x5204        # top.mixed[63:32]，字 0 与基址重合、字 1 需装配
+	load %r7, 0x5004        # #6 激励变化后重新装配的 top.bus64[63:32]
+	ret
@@ -0,0 +1,9 @@
+	.text
+	.globl	main
+main:                                   # 轮询 top.ready 直到 stimulus.vcd 在 #150000 将其置 1：空转跳过停在激励变化之前，
+	mov %r2, 1                          # trigger 的指令数在跳过/逐条执行、--jit 与 CORE=switch 下相同
+.Lpoll:
+	load %r1, 0x7000
+	jmpc 1, %r1, %r2, @.Lpoll
+	trigger
+	ret
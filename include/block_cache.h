@@ -0,0 +1,88 @@
+#ifndef BLOCK_CACHE_H
+#define BLOCK_CACHE_H
+
+#include <stdint.h>
+#include "decode_cache.h"
+
+// 单个基本块最多收录的指令条数
+#define BLOCK_MAX_INSTS 64
+
+//=====================================================================================
+//   超级指令：常见相邻指令对融合为一次分派，编号接在 INST_OP_* 之后
+//=====================================================================================
+#define TSL_SUPER_OPS(X) \
+    X(LOAD_SLICE)   /* load rX; bit_slice rY rX[..]        */ \
+    X(LOAD_JMPC)    /* load rX; jmpc rX ?? rY               */ \
+    X(SLICE_EDGE)   /* bit_slice rX ..; edge_detect rY rX   */ \
+    X(MOVI_JMPC)    /* mov rX, imm; jmpc rY ?? rX           */
+
+#define TSL_SUPER_OP_ENUM(name) SUPER_OP_##name,
+enum {
+    SUPER_OP_FIRST = INST_OP_COUNT - 1,
+    TSL_SUPER_OPS(TSL_SUPER_OP_ENUM)
+    BLOCK_OP_END,           // 块结束标记
+    BLOCK_OP_COUNT
+};
+#undef TSL_SUPER_OP_ENUM
+
+struct CPU;
+
+// BlockOp.sample：对应指令开始前须采样信号存储（其余指令不采样，见 block_build）
+#define BLOCK_SAMPLE_A  0x1
+#define BLOCK_SAMPLE_B  0x2
+
+typedef struct BLOCK_OP {
+    uint16_t op;                // INST_OP_* / SUPER_OP_* / BLOCK_OP_END
+    uint8_t  sample;            // BLOCK_SAMPLE_A / BLOCK_SAMPLE_B
+    const DecodedInst* a;       // 第一条（或唯一一条）指令
+    const DecodedInst* b;       // 超级指令的第二条指令
+} BlockOp;
+
+//=====================================================================================
+//   基本块：从入口 PC 顺序执行到第一条控制转移指令（含）
+//=====================================================================================
+typedef struct BASIC_BLOCK {
+    uint32_t start_pc;
+    uint32_t end_pc;            // 块内最后一条指令之后的地址
+    uint32_t ninsts;            // 融合前的指令条数，用于定时器预算
+    uint8_t  exact;             // 1：块内含 timer_set，须逐条检查定时器到期
+    uint8_t  pure;              // 1：块内没有 send/trigger/domain_set/timer_set 等副作用，可属于空转循环
+    uint64_t generation;        // 构建时的解码缓存代数，不一致即失效重建
+    uint32_t hits;              // 执行次数，达到 JIT_HOT_THRESHOLD 后尝试编译
+    uint32_t jit_nops;          // 本机代码覆盖的前缀操作数，其后的操作回到解释器执行
+    uint32_t jit_ninsts;        // 本机代码覆盖的指令条数（超级指令计两条）
+    void   (*jit_code)(struct CPU* cpu); // 本机代码入口，未编译为 NULL
+    void*    jit_chain;         // 链接入口（整块编译时），前驱块的本机代码直接跳入；否则为 NULL
+    uint32_t jit_nexits;        // 静态出口数（jmp/bl 1 个、jmpc 2 个、无终结指令 1 个、ret 0 个）
+    uint32_t jit_exit_pc[2];    // 各静态出口的目标 PC
+    void*    jit_next[2];       // 各出口已链接的后继块链接入口，NULL 时回到调度循环
+    BlockOp  ops[];             // 以 BLOCK_OP_END 结尾
+} BasicBlock;
+
+typedef struct BLOCK_CACHE {
+    BasicBlock** by_pc;         // 按入口 PC 索引，覆盖与解码缓存相同的镜像范围
+    uint64_t base;
+    uint64_t size;
+} BLOCK_CACHE;
+
+int  block_cache_init(BLOCK_CACHE* bc, uint64_t base, uint64_t size);
+void block_cache_free(BLOCK_CACHE* bc);
+BasicBlock* block_cache_get(BLOCK_CACHE* bc, struct CPU* cpu, uint64_t pc);
+
+// 没有副作用的指令：只读写寄存器与 PC、读信号值与边沿采样，quiet/summary 级别下不输出、不改定时器
+// （块的 pure 标记；switch 内核逐条判断空转循环时也使用）
+static inline int inst_side_effect_free(uint16_t op) {
+    return op == INST_OP_MOV || op == INST_OP_MOVI || op == INST_OP_JMP || op == INST_OP_BL || op == INST_OP_RET ||
+           op == INST_OP_BIT_SLICE || op == INST_OP_LOAD || (op >= INST_OP_EDGE_P && op <= INST_OP_EDGE_X) ||
+           (op >= INST_OP_JMPC_EQ && op <= INST_OP_JMPC_NEG) || (op >= INST_OP_ARITH_AND && op <= INST_OP_ARITH_SUB);
+}
+
+// 调度快路径：已缓存且未过期时直接返回，否则返回 NULL 由 block_cache_get 构建
+static inline BasicBlock* block_cache_lookup(BLOCK_CACHE* bc, uint64_t pc, uint64_t generation) {
+    uint64_t off = pc - bc->base;
+    if (off >= bc->size) return NULL;
+    BasicBlock* b = bc->by_pc[off];
+    return b && b->generation == generation ? b : NULL;
+}
+
+#endif
@@ -3,10 +3,40 @@
 
 #include "dram.h"
 
+struct DECODE_CACHE;
+
+//=====================================================================================
+//   MMIO 设备：挂到总线的地址区间上（信号组、触发/采样缓冲、计数器、调试 CSR 等），
+//   区间内的 load/store 交给设备回调，其余访问落到 DRAM
+//=====================================================================================
+typedef struct BUS_DEVICE {
+    const char* name;
+    uint64_t    base;       // 起始地址
+    uint64_t    size;       // 字节数
+    void*       ctx;        // 回调的第一个参数
+    uint64_t  (*read)(void* ctx, uint64_t offset, uint64_t size);                   // offset 为区间内偏移，size 为位宽
+    void      (*write)(void* ctx, uint64_t offset, uint64_t size, uint64_t value);  // 可为 NULL（只读，写入被忽略）
+} BUS_DEVICE;
+
 typedef struct BUS {
     struct DRAM dram;
+    struct DECODE_CACHE* icache;    // 写总线时需要失效的解码缓存，可为 NULL
+    BUS_DEVICE* devices;            // 按 base 升序，区间互不重叠
+    uint32_t    ndevices;
+    uint64_t    io_lo, io_hi;       // 所有设备区间的包络 [io_lo, io_hi)：区间外的访问直接走 DRAM
 } BUS;
 
+int  bus_register_device(BUS* bus, const BUS_DEVICE* dev);
+const BUS_DEVICE* bus_find_device(const BUS* bus, uint64_t addr);
+void bus_free_devices(BUS* bus);
+
+// 包络之外（包括未注册任何设备时）一次比较即返回 NULL，DRAM 访问不查表
+static inline const BUS_DEVICE* bus_io_device(const BUS* bus, uint64_t addr) {
+    if (addr < bus->io_lo || addr >= bus->io_hi)
+        return NULL;
+    return bus_find_device(bus, addr);
+}
+
 uint64_t bus_load(BUS* bus, uint64_t addr, uint64_t size);
 void bus_store(BUS* bus, uint64_t addr, uint64_t size, uint64_t value);
 
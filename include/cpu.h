@@ -3,31 +3,96 @@
 
 #include <stdint.h>
 #include "bus.h"
+#include "decode_cache.h"
+#include "block_cache.h"
+#include "jit.h"
+#include "trace.h"
+#include "vcd.h"
+#include "dbg_csr.h"
+#include "stimulus.h"
+#include "signal_store.h"
+#include "timer_sched.h"
 
 // VU13P中，BRAM数为2688，URAM数为1280
 // 单个Block RAM是36K bit，单个Ultra RAM是288K bit
 // BRAM数为 2688 * 36K = 94.5M bit = 12MB
 // URAM数为 1280 * 288K = 360M bit = 45MB
-// 总内存为94.5M + 360M = 454.5M bit = 56.8M Byte
+// 总内存为94.5M + 360M = 454.5M bit = 56.8M Byte（DRAM_MAX_SIZE，--dram-size=max）
+
+// timer_set 可寻址的定时器个数（id 字段 2 位，当前硬件实现 timer0/timer1）
+#define CPU_TIMER_COUNT 2
+
+// 空转检测：状态不同后隔多少次向后跳转再取快照；快照的入口多少次向后跳转未再到达即放弃
+#define IDLE_PROBE_INTERVAL 16
+#define IDLE_PROBE_SPAN     64
+
+//=====================================================================================
+//   空转检测：在向后跳转的目标（循环入口）处对机器状态取快照，下一次经向后跳转回到该入口时
+//   寄存器与外部输入都与快照相同、期间也没有执行过有副作用的块，则之后每一遍都会
+//   重复这一遍，程序在等待外部事件
+//=====================================================================================
+typedef struct IDLE_SNAPSHOT {
+    uint32_t pc;                // 循环入口
+    uint32_t regs[16];
+    uint32_t ret_reg;
+    uint64_t epoch;             // 副作用计数
+    uint64_t stim_changes;      // 已应用的激励变化数
+    uint64_t timer_next;        // 最早的定时器到期时间
+    uint64_t time;              // 已执行指令数
+    uint64_t misses;            // load 未命中次数
+} IDLE_SNAPSHOT;
+
+typedef struct IDLE_PROBE {
+    uint64_t epoch;             // 执行有副作用的块（或单步执行）时加一
+    uint8_t  armed;             // 1：已取快照，等待回到快照的入口
+    uint32_t wait;              // 取快照后经过的向后跳转次数
+    uint32_t cooldown;          // 距下一次取快照还需的向后跳转次数
+    IDLE_SNAPSHOT snap;
+} IDLE_PROBE;
 
 typedef struct CPU {
     uint32_t regs[16];          // 14 32-bit GPR registers (R0-R13), 2 32bit COUNTER register (R14-R15) 
     uint32_t pc;                // 32-bit program counter
     uint32_t ret_reg;           // 返回地址寄存器
-    uint32_t prev_regs[14];     // 上一周期（或上一条指令执行前）寄存器快照：用于比较变化、生成display信息、触发trace/观察点，避免在同一周期内读写竞争；R0-R13按顺序对应
     struct BUS bus;             // CPU connected to BUS
     uint8_t  domain;
-    uint64_t timer[2];
-    uint8_t  timer_enabled[2];
-    uint64_t timer_threshold[2];   // 计时器阈值，当计数达到该值触发跳转
-    uint32_t timer_target_pc[2];   // 计时器触发后的目标PC（绝对地址，DRAM 基址空间）
+    TIMER_SCHED timers;         // 定时器与按到期时间排序的事件队列，计数由已执行指令数推算
+    DECODE_CACHE icache;        // 程序镜像的预解码缓存（按PC索引）
+    BLOCK_CACHE  bcache;        // 基本块缓存（线程化内核使用）
+    JIT      jit;               // 热点基本块的本机代码（--jit 打开，线程化内核使用）
+    uint64_t inst_retired;      // 已执行指令数（结束汇总）
+    uint64_t inst_skipped;      // 其中空转检测直接跳过、未逐条执行的指令数
+    uint64_t send_count;        // 已执行 send 数
+    uint64_t trigger_count;     // 已执行 trigger/trigger_pos 数
+    TRACE    trace;             // 二进制执行轨迹（--trace-file 打开）
+    VCD      vcd;               // VCD 波形（--vcd 打开）
+    uint8_t  dump_changes;      // 1：dump_registers 只打印变化的寄存器（--reg-dump=changes）
+    REG_DELTA dump_delta;       // 增量寄存器打印的上一次值
+    DBG_CSR  dbg;               // 调试 CSR（--dbg-csr 时挂到总线 DBG_CSR_BASE）
+    STIMULUS stim;              // 波形激励（--stimulus 打开），load 前按已执行指令数推进
+    SIGNAL_STORE sig;           // 采样信号存储：R0-R13 的 bit0 的当前/上一 FCLK 周期值，供边沿类指令查表
+    IDLE_PROBE idle;            // 空转循环检测（quiet/summary 级别）
 } CPU;
 
 // CPU基本操作函数
-void cpu_init(struct CPU *cpu);
+int cpu_init(struct CPU *cpu, uint64_t dram_size);
 uint64_t cpu_fetch(struct CPU *cpu, uint8_t *inst_length);
 int cpu_execute(struct CPU *cpu, uint64_t inst, uint8_t inst_length);
+int cpu_decode(uint64_t inst, uint8_t inst_length, DecodedInst *d);
+void cpu_init_caches(struct CPU *cpu, uint64_t image_size);
+const DecodedInst* cpu_fetch_decoded(struct CPU *cpu);
+const DecodedInst* cpu_decode_at(struct CPU *cpu, uint64_t pc);
+int cpu_execute_decoded(struct CPU *cpu, const DecodedInst *d);
+int cpu_enable_jit(struct CPU *cpu);
+void cpu_trace_retired(struct CPU *cpu, const DecodedInst *d, uint32_t pc);
+void cpu_sample_cycle(struct CPU *cpu, uint32_t ahead);
+void cpu_idle_probe(struct CPU *cpu, uint32_t pc);
+void cpu_print_inst(const DecodedInst *d, uint32_t pc);
+int  cpu_render_event(uint16_t ev, const uint32_t *args);
+uint32_t cpu_load_signal(struct CPU *cpu, uint32_t addr);
+void cpu_run(struct CPU *cpu);
 void dump_registers(struct CPU *cpu);
+void cpu_print_summary(struct CPU *cpu, double seconds);
 void cpu_cleanup(struct CPU *cpu);
 
 // DB信息表相关函数
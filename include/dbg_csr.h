@@ -0,0 +1,48 @@
+#ifndef DBG_CSR_H
+#define DBG_CSR_H
+
+#include <stdint.h>
+#include "bus.h"
+
+// 调试 CSR 区间：寄存器偏移同 doc/TSL软核CPU调试器设计.md “调试寄存器地址示例”，
+// 基址放在 load 24 位地址空间的最后 4KB（文档示例的 0x1000 起与 signal_table 的内置信号重叠）
+#define DBG_CSR_BASE    0xFFF000
+#define DBG_CSR_SIZE    0x14
+
+// DBG_CTRL 位域：bit0 halt, bit1 step, bit2 resume, bit3 debug_mode, bit[7:4] reason_code
+// 调试 CSR 目前只是存储：halt/step/resume 按设计文档的读写语义保存，不暂停或单步 CPU
+#define DBG_CTRL_HALT       0x1
+#define DBG_CTRL_STEP       0x2
+#define DBG_CTRL_RESUME     0x4
+#define DBG_CTRL_DEBUG_MODE 0x8
+#define DBG_CTRL_REASON(v)  (((v) >> 4) & 0xF)
+#define DBG_CTRL_MASK       0xFF
+
+//=====================================================================================
+//   调试 CSR：名称、区间内偏移、是否可写（dbg_csr_store 按此列拒绝写入）
+//=====================================================================================
+#define TSL_DBG_CSRS(X) \
+    X(CTRL,      0x00, 1)   /* 调试使能/断点控制/step/resume */ \
+    X(PC,        0x04, 0)   /* 读它的 load 指令的 PC（只读） */ \
+    X(BP_ADDR,   0x08, 1)   /* 断点地址 */                      \
+    X(TRACE_PTR, 0x10, 1)   /* 追踪缓冲读指针 */
+
+#define TSL_DBG_CSR_ENUM(name, offset, writable) DBG_##name = offset,
+typedef enum DBG_CSR_REG {
+    TSL_DBG_CSRS(TSL_DBG_CSR_ENUM)
+} DBG_CSR_REG;
+#undef TSL_DBG_CSR_ENUM
+
+typedef struct DBG_CSR {
+    uint32_t ctrl;
+    uint32_t bp_addr;
+    uint32_t trace_ptr;
+    const uint32_t* pc;     // CPU 程序计数器，DBG_PC 由它减去 DBG_LOAD_LENGTH 得到
+} DBG_CSR;
+
+// 读 CSR 的 load 指令长度：读设备时 PC 已指向下一条指令
+#define DBG_LOAD_LENGTH 4
+
+int dbg_csr_attach(DBG_CSR* dbg, BUS* bus, const uint32_t* pc);
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef DECODE_CACHE_H
+#define DECODE_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 最长指令为8字节：失效时起点需前推 (DECODE_MAX_INST_LEN - 1) 字节，覆盖跨越写入地址的指令
+#define DECODE_MAX_INST_LEN 8
+// 失效粒度：按 16 字节行整体失效
+#define DECODE_LINE_SIZE    16
+
+//=====================================================================================
+//   处理函数编号：每个 (长度, opcode, func) 组合一个，驱动 exec 表与线程化分派的标签表
+//=====================================================================================
+#define TSL_INST_OPS(X) \
+    X(INVALID)                                                          \
+    /* 1 字节 */                                                        \
+    X(TRIGGER) X(RET)                                                   \
+    /* 2 字节 */                                                        \
+    X(TRIGGER_POS) X(JMP) X(MOV) X(BL) X(DOMAIN_SET)                    \
+    X(SEND_DISPLAY) X(SEND_EXEC) X(SEND_UNKNOWN)                        \
+    X(EDGE_P) X(EDGE_N) X(EDGE_T) X(EDGE_L) X(EDGE_H) X(EDGE_S)         \
+    X(EDGE_X) X(EDGE_UNKNOWN)                                           \
+    /* 4 字节 */                                                        \
+    X(JMPC_EQ) X(JMPC_NE) X(JMPC_GT) X(JMPC_LT) X(JMPC_GE) X(JMPC_LE)   \
+    X(JMPC_POS) X(JMPC_NEG) X(JMPC_UNKNOWN)                             \
+    X(ARITH_AND) X(ARITH_OR) X(ARITH_XOR)                               \
+    X(ARITH_REDU_AND) X(ARITH_REDU_OR) X(ARITH_REDU_XOR)                \
+    X(ARITH_CONCAT) X(ARITH_ISUNKNOW) X(ARITH_ADD) X(ARITH_SUB)         \
+    X(ARITH_UNKNOWN)                                                    \
+    X(BIT_SLICE) X(LOAD)                                                \
+    /* 8 字节 */                                                        \
+    X(MOVI) X(MOVI_INVALID)                                             \
+    X(TIMER_RESET) X(TIMER_DISABLE) X(TIMER_ENABLE) X(TIMER_CFG_ENABLE) \
+    X(TIMER_INVALID)
+
+#define TSL_INST_OP_ENUM(name) INST_OP_##name,
+typedef enum INST_OP {
+    TSL_INST_OPS(TSL_INST_OP_ENUM)
+    INST_OP_COUNT
+} INST_OP;
+#undef TSL_INST_OP_ENUM
+
+struct CPU;
+struct DECODED_INST;
+
+typedef void (*exec_fn)(struct CPU* cpu, const struct DECODED_INST* d);
+
+//=====================================================================================
+//   预解码指令记录：取指、长度判定与位域解析的结果，exec_* 直接读取字段
+//=====================================================================================
+typedef struct DECODED_INST {
+    uint64_t raw;       // 原始指令（低 length*8 位有效）
+    exec_fn  exec;      // 执行函数，与 op 一一对应
+    uint16_t op;        // INST_OP_*：按 (长度, opcode, func) 细分的处理函数编号
+    uint8_t  valid;     // 1 表示记录可复用（已缓存）
+    uint8_t  length;    // 指令字节数 1/2/4/8，0 表示非法
+    uint8_t  opcode;    // [op] 高4位
+    uint8_t  func;      // func 字段（jmpc/arith_op/edge_detect/send/timer_set/mov）
+    uint8_t  rd;        // 目标寄存器；timer_set 时为计时器 id
+    uint8_t  rs1;       // 源寄存器1
+    uint8_t  rs2;       // 源寄存器2
+    uint8_t  hi;        // bit_slice end
+    uint8_t  lo;        // bit_slice start
+    int32_t  offset;    // 已符号扩展的 PC 相对偏移（jmpc/jmp/bl/timer_set）
+    uint32_t imm;       // 立即数：movi imm / load addr / timer 阈值 / send db_id / domain id / trigger_pos
+} DecodedInst;
+
+//=====================================================================================
+//   解码缓存：覆盖程序镜像 [base, base+size)，按 PC 直接索引
+//=====================================================================================
+typedef struct DECODE_CACHE {
+    DecodedInst* entries;   // 每个字节地址一个槽位，未命中时懒解码填充
+    uint64_t base;
+    uint64_t size;
+    DecodedInst scratch;    // 镜像范围外的临时解码结果，不缓存
+    uint64_t generation;    // 每次失效递增，依赖解码结果的上层缓存（基本块）据此判断是否过期
+} DECODE_CACHE;
+
+int  decode_cache_init(DECODE_CACHE* dc, uint64_t base, uint64_t size);
+void decode_cache_free(DECODE_CACHE* dc);
+void decode_cache_invalidate(DECODE_CACHE* dc, uint64_t addr, uint64_t bytes);
+
+/*
+ * decode_cache_lookup
+ * 作用：按 PC 取缓存槽位。
+ * 返回：镜像范围内返回槽位指针（可能尚未 valid）；范围外返回 NULL。
+ */
+static inline DecodedInst* decode_cache_lookup(DECODE_CACHE* dc, uint64_t pc) {
+    uint64_t off = pc - dc->base;
+    return off < dc->size ? &dc->entries[off] : NULL;
+}
+
+#endif
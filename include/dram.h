@@ -2,19 +2,102 @@
 #define DRAM_H
 
 #include <stdint.h>
+#include <stddef.h>
 
 // TSL源程序假设有200条指令，指令最大字节为8B，总字节数为 200 * 8 = 1600B
 // 对应的1600B / 1024 = 1.56KB，1.56KB / 1024 = 0.0156MB，
 // 所以DRAM大小至少为 1.56KB * 2 = 3.12KB
-// 为了方便，我们将DRAM大小设置为 1024 * 32 = 32KB，小于一个BRAM的块RAM大小
+// 为了方便，我们将默认DRAM大小设置为 1024 * 32 = 32KB，小于一个BRAM的块RAM大小
+// 运行时可通过 --dram-size 设置，最大为 VU13P 片上 BRAM+URAM 总量（见 cpu.h）
 // 同时，为了方便，我们将DRAM的基地址设置为 0x00000000
-#define DRAM_SIZE 1024*32
+#define DRAM_DEFAULT_SIZE (1024u * 32)
+#define DRAM_MAX_SIZE     ((2688ull * 36 * 1024 + 1280ull * 288 * 1024) / 8)  // 59572224B = 56.8MB
 #define DRAM_BASE 0x00000000
 
+// 页表粒度：与宿主页大小一致，镜像文件的映射页可直接作为 DRAM 页
+#define DRAM_PAGE_SHIFT 12
+#define DRAM_PAGE_SIZE  (1u << DRAM_PAGE_SHIFT)
+
+// 稀疏 DRAM：页表按需分配，未写过的页读为 0，只有写入过或镜像所在的页占用内存
 typedef struct DRAM {
-	uint8_t mem[DRAM_SIZE];     // Dram memory of DRAM_SIZE
+    uint64_t  size;             // 字节数（--dram-size）
+    uint32_t  npages;
+    uint8_t** pages;            // 页表：NULL 为未分配（读为 0），首次写入时分配
+    uint8_t*  image;            // 镜像的写时复制映射，页表前若干项直接指向其中的页
+    size_t    image_bytes;
 } DRAM;
 
+#define DRAM_PAGE_MASK  (DRAM_PAGE_SIZE - 1)
+
+uint64_t dram_load_split(const DRAM* dram, uint64_t off, unsigned bytes);
+void     dram_store_split(DRAM* dram, uint64_t off, unsigned bytes, uint64_t value);
+
+//=====================================================================================
+//   快速路径：不检查边界、不打印诊断，调用方保证 [addr, addr + N/8) 在 DRAM 内
+//   （取指前已按 DRAM 大小校验、镜像已加载等）。页内访问为一次非对齐读写加字节序翻转，
+//   跨页访问或写未分配的页走 dram_load_split/dram_store_split。
+//=====================================================================================
+// 小端宿主上读出后翻转为 TSL 的大端序
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define DRAM_BE16(v) (v)
+#define DRAM_BE32(v) (v)
+#define DRAM_BE64(v) (v)
+#else
+#define DRAM_BE16(v) __builtin_bswap16(v)
+#define DRAM_BE32(v) __builtin_bswap32(v)
+#define DRAM_BE64(v) __builtin_bswap64(v)
+#endif
+
+#define TSL_DRAM_FAST_WIDTHS(X) \
+    X(16, uint16_t, DRAM_BE16)  \
+    X(32, uint32_t, DRAM_BE32)  \
+    X(64, uint64_t, DRAM_BE64)
+
+static inline uint64_t dram_fast_load_8(const DRAM* dram, uint64_t addr) {
+    uint64_t off = addr - DRAM_BASE;
+    const uint8_t* page = dram->pages[off >> DRAM_PAGE_SHIFT];
+    return page ? page[off & DRAM_PAGE_MASK] : 0;
+}
+
+static inline void dram_fast_store_8(DRAM* dram, uint64_t addr, uint64_t value) {
+    uint64_t off = addr - DRAM_BASE;
+    uint8_t* page = dram->pages[off >> DRAM_PAGE_SHIFT];
+    if (page)
+        page[off & DRAM_PAGE_MASK] = (uint8_t)value;
+    else
+        dram_store_split(dram, off, 1, value);
+}
+
+#define TSL_DRAM_FAST_ACCESS(bits, type, bswap)                                     \
+static inline uint64_t dram_fast_load_##bits(const DRAM* dram, uint64_t addr) {      \
+    uint64_t off = addr - DRAM_BASE;                                                \
+    const uint8_t* page = dram->pages[off >> DRAM_PAGE_SHIFT];                      \
+    if ((off & DRAM_PAGE_MASK) > DRAM_PAGE_SIZE - (bits) / 8)                       \
+        return dram_load_split(dram, off, (bits) / 8);                              \
+    if (!page)                                                                      \
+        return 0;                                                                   \
+    type v;                                                                         \
+    __builtin_memcpy(&v, page + (off & DRAM_PAGE_MASK), sizeof(v));                 \
+    return bswap(v);                                                                \
+}                                                                                   \
+static inline void dram_fast_store_##bits(DRAM* dram, uint64_t addr, uint64_t value) {\
+    uint64_t off = addr - DRAM_BASE;                                                \
+    uint8_t* page = dram->pages[off >> DRAM_PAGE_SHIFT];                            \
+    if (!page || (off & DRAM_PAGE_MASK) > DRAM_PAGE_SIZE - (bits) / 8) {            \
+        dram_store_split(dram, off, (bits) / 8, value);                             \
+        return;                                                                     \
+    }                                                                               \
+    type v = bswap((type)value);                                                    \
+    __builtin_memcpy(page + (off & DRAM_PAGE_MASK), &v, sizeof(v));                 \
+}
+TSL_DRAM_FAST_WIDTHS(TSL_DRAM_FAST_ACCESS)
+#undef TSL_DRAM_FAST_ACCESS
+
+int  dram_init(DRAM* dram, uint64_t size);
+int  dram_parse_size(const char* s, uint64_t* size);
+int  dram_map_image(DRAM* dram, int fd, size_t bytes);
+void dram_free(DRAM* dram);
+
 uint64_t dram_load(DRAM* dram, uint64_t addr, uint64_t size);
 uint64_t dram_load_8(DRAM* dram, uint64_t addr);
 uint64_t dram_load_16(DRAM* dram, uint64_t addr);
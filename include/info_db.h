@@ -1,6 +1,7 @@
 #ifndef INFO_DB_H
 #define INFO_DB_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "cpu.h"
@@ -13,23 +14,112 @@ struct signal_entry {
     uint32_t value;
 };
 
+// 支持的拆分字字节数：装配计划与波形激励均按 32 位拆分字处理，其它值的信号加载时跳过
+#define SIGNAL_WORD_BYTES 4
+
+// signal_split.db 中的一个信号：宽信号按 32 位拆分到多个字地址
+typedef struct SIGNAL_SPLIT {
+    char*     name;         // 完整层次名，如 "top.op"
+    uint32_t  addr;         // 基址：基址 + 4k 为装配后的位 [32k+31:32k]
+    uint32_t  width;        // 位宽
+    uint32_t  word_bytes;   // 每个拆分字的字节数，恒为 SIGNAL_WORD_BYTES
+    uint32_t  nwords;
+    uint32_t* words;        // 各拆分字地址，words[k] 对应位 [32k+31:32k]
+} SIGNAL_SPLIT;
+
+//=====================================================================================
+//   编译后的信息库（tools/tsl_dbc 生成，位于 DB 目录下的 info.tdb）：
+//   文件头 + 各表按 ID 排序的条目与直接索引 + 字符串区，所有引用均为文件内偏移，
+//   运行时整体 mmap 后原地使用，不逐条解析或分配；文件不存在或比文本 *.db 旧时回退到文本解析
+//=====================================================================================
+#define INFO_DB_FILE        "info.tdb"
+#define INFO_DB_MAGIC       "TSLINFDB"
+#define INFO_DB_VERSION     2
+#define INFO_DB_NONE        0xFFFFFFFFu     // 无字符串（domain/instance 条目的类型）
+
+// 一个 ID 表：条目与直接索引（ID -> 条目下标 + 1，0 为空）的偏移，条目中的字符串为相对 strings 的偏移
+typedef struct INFO_DB_TABLE {
+    uint32_t count;
+    uint32_t entries;       // INFO_DB_ENTRY[count]，按 ID 升序
+    uint32_t direct_size;   // 0 表示 ID 稀疏，查找时二分
+    uint32_t direct;        // uint32_t[direct_size]
+    uint32_t strings;
+    uint32_t strings_size;  // 字符串区以 '\0' 结尾
+    uint32_t args;          // uint32_t[nargs]，各条目的参数信号地址依次排列
+    uint32_t nargs;
+} INFO_DB_TABLE;
+
+typedef struct INFO_DB_ENTRY {
+    uint32_t id;
+    uint32_t type;          // 驻留的类型字符串，INFO_DB_NONE 表示无
+    uint32_t content;
+    uint32_t args;          // 参数（如 display 的信号地址列表）在 args 区中的下标
+    uint32_t nargs;
+} INFO_DB_ENTRY;
+
+// signal_split.db 的一个信号，name 为相对 split_strings 的偏移，words 为 uint32_t[nwords] 的文件偏移
+typedef struct INFO_DB_SPLIT {
+    uint32_t name;
+    uint32_t addr;
+    uint32_t width;
+    uint32_t word_bytes;
+    uint32_t nwords;
+    uint32_t words;
+} INFO_DB_SPLIT;
+
+typedef struct INFO_DB_HEADER {
+    char          magic[8];         // INFO_DB_MAGIC
+    uint32_t      version;
+    uint32_t      size;             // 文件总长，映射时校验
+    INFO_DB_TABLE builtin;
+    INFO_DB_TABLE domain;
+    INFO_DB_TABLE instance;
+    uint32_t      nsplits;
+    uint32_t      splits;           // INFO_DB_SPLIT[nsplits]，按名称排序
+    uint32_t      split_strings;
+    uint32_t      split_strings_size;
+} INFO_DB_HEADER;
+
 // 基础设施
 void set_info_base(const char* dir);
 void info_db_init_all(CPU* cpu);
 uint32_t get_signal_value(uint32_t addr);
 
+// 信号索引（内置示例值 + signal_split.db 中的地址）
+void init_signal_index();
+void free_signal_index();
+const SIGNAL_SPLIT* find_signal_split(const char* name);
+int set_signal_value(uint32_t addr, uint32_t value);
+int signal_exists(uint32_t addr);
+void signal_gather_run();
+uint64_t get_signal_miss_count();
+void add_signal_miss_count(uint64_t n);
+
 // Builtin 信息表
 void init_builtin_info_table();
 void free_builtin_info_table();
 char* get_builtin_info(uint32_t id);
 char* get_builtin_type(uint32_t id);
+const char* builtin_send_line(uint32_t id, uint8_t func, size_t* len);
+
+// 预取加载镜像引用的条目（cpu_init_caches 扫描 send 的 db_id 与 domain_set 的域号时调用）
+void prefetch_builtin_info(uint32_t id);
+void prefetch_domain_info(uint32_t id);
 
 // Domain 信息表
 void init_domain_info_table();
 void free_domain_info_table();
 char* get_domain_info(uint32_t id);
 
+// Instance 信息表（instance_info.db，可缺省）
+void init_instance_info_table();
+void free_instance_info_table();
+char* get_instance_info(uint32_t id);
+
+// 将 DB 目录下的文本 *.db 编译为 path（tools/tsl_dbc）
+int info_db_compile(const char* path);
+
 // Timer 跳转
-void timer_tick_and_jump(CPU* cpu);
+int timer_tick_and_jump(CPU* cpu);
 
 #endif
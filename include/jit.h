@@ -0,0 +1,36 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "block_cache.h"
+
+// 基本块执行次数达到该值后编译为本机代码
+#define JIT_HOT_THRESHOLD   16
+// 代码区大小：按块顺序追加，用满后不再编译新块（已编译块继续使用）
+#define JIT_CODE_SIZE       (4u << 20)
+// 调度循环每次进入本机代码后，最多经链接连续执行的块数；用完回到调度循环
+#define JIT_CHAIN_BUDGET    256
+
+//=====================================================================================
+//   x86-64 JIT：将热点基本块中纯寄存器运算/跳转的前缀编译为本机代码
+//=====================================================================================
+typedef struct JIT {
+    uint8_t* code;      // mmap 代码区，编译时可写，执行时只读可执行
+    size_t   cap;
+    size_t   used;
+    uint8_t  enabled;   // 运行时开关（--jit），且宿主支持
+    uint8_t  trace;     // 1：每条指令后回调 cpu_trace_retired（trace 及以上日志级别）
+    uint8_t  idle;      // 1：链接的向后出口调用 cpu_idle_probe（主循环做空转检测时设置）
+    uint32_t budget;    // 本次进入后剩余可链接的块数，链接入口递减
+    BasicBlock* last;   // 从块尾出口返回时本机代码在此留下所在块，调度循环取到后继块后补上链接
+} JIT;
+
+struct CPU;
+
+int  jit_init(JIT* jit);
+void jit_free(JIT* jit);
+int  jit_compile(JIT* jit, BasicBlock* b);
+void jit_link(BasicBlock* from, BasicBlock* to);
+
+#endif
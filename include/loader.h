@@ -0,0 +1,10 @@
+#ifndef LOADER_H
+#define LOADER_H
+
+#include <stddef.h>
+#include "cpu.h"
+
+// 程序镜像加载：emulator 与 AOT 生成的可执行文件共用，输出一致
+size_t read_file(CPU* cpu, const char *filename, int dump);
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+//=====================================================================================
+//   日志级别：quiet < summary < trace < full
+//     quiet   ：只输出 send 结果、trigger 事件与结束汇总
+//     summary ：另加启动信息、域/定时器等运行事件
+//     trace   ：另加逐条指令的地址与反汇编、load 取值
+//     full    ：另加内存转储与每条指令后的寄存器转储（默认，与原输出一致）
+//   错误信息始终输出到 stderr。
+//=====================================================================================
+typedef enum LOG_LEVEL {
+    LOG_QUIET = 0,
+    LOG_SUMMARY,
+    LOG_TRACE,
+    LOG_FULL
+} LOG_LEVEL;
+
+extern LOG_LEVEL g_log_level;
+
+// 运行时判断；执行内核按级别各实例化一份主循环，逐指令路径上的判断在编译期消除
+#define LOG_ENABLED(level) (g_log_level >= (level))
+
+void set_log_level(LOG_LEVEL level);
+int  log_level_parse(const char* name, LOG_LEVEL* level);
+const char* log_level_name(LOG_LEVEL level);
+
+//=====================================================================================
+//   标准输出后端：log_printf 为所有 stdout 日志的统一入口
+//     默认直接 vprintf；打开异步模式后，各线程写入自己的无锁环形缓冲区（单生产者/单消费者），
+//     后台写线程按线程顺序取出写到 stdout，仿真线程不再等待终端或管道读取
+//=====================================================================================
+// 每个线程的缓冲区字节数（2 的幂）
+#define LOG_ASYNC_BUF_SIZE  (4u << 20)
+
+// 缓冲区满时的处理策略
+typedef enum LOG_BACKPRESSURE {
+    LOG_BP_BLOCK = 0,   // 等待写线程腾出空间，输出完整
+    LOG_BP_DROP         // 丢弃整条消息并计数，仿真不等待
+} LOG_BACKPRESSURE;
+
+int  log_printf(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+int  log_write(const char* s, size_t n);
+int  log_backpressure_parse(const char* name, LOG_BACKPRESSURE* policy);
+int  log_async_start(LOG_BACKPRESSURE policy);
+void log_async_stop(void);
+
+//=====================================================================================
+//   延迟格式化（--log-deferred）：逐条指令的输出只写事件号与原始参数，
+//   tools/tsl_logfmt 离线调用同一组打印函数（cpu_render_event）还原文本
+//=====================================================================================
+#define LOG_DEFERRED_MAGIC     "TSLLOGD"
+#define LOG_DEFERRED_VERSION   1
+#define LOG_DEFERRED_BUF_SIZE  (1u << 20)
+
+#define TSL_LOG_EVENTS(X) \
+    X(TEXT)     /* 已格式化文本（其余 log_printf 输出），n 为字节数 */   \
+    X(ADDR)     /* pc：指令地址 */                                       \
+    X(DISASM)   /* raw 低/高 32 位, length：反汇编 */                     \
+    X(LOAD)     /* addr, val：load 取值 */                                \
+    X(REGS)     /* R0-C1, RET, T0/T1 低/高 32 位, PC：寄存器转储 */
+
+#define TSL_LOG_EVENT_ENUM(name) LOG_EV_##name,
+typedef enum LOG_EVENT {
+    TSL_LOG_EVENTS(TSL_LOG_EVENT_ENUM)
+    LOG_EV_COUNT
+} LOG_EVENT;
+#undef TSL_LOG_EVENT_ENUM
+
+// 文件头之后为事件序列：LogEventHdr + n 个 uint32_t 参数（TEXT 为 n 字节文本）
+typedef struct LogDeferredHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t reserved;
+} LogDeferredHeader;
+
+typedef struct LogEventHdr {
+    uint16_t ev;
+    uint16_t n;
+} LogEventHdr;
+
+extern int g_log_deferred;
+
+int  log_deferred_open(const char* path);
+void log_deferred_close(void);
+void log_event(LOG_EVENT ev, uint16_t n, const uint32_t* args);
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef REG_DELTA_H
+#define REG_DELTA_H
+
+#include <stdint.h>
+
+//=====================================================================================
+//   可观测寄存器：名称与位宽，驱动变化检测、增量寄存器打印与 VCD 变量表
+//=====================================================================================
+#define TSL_REG_SIGNALS(X) \
+    X(R0, 32)  X(R1, 32)  X(R2, 32)  X(R3, 32)      \
+    X(R4, 32)  X(R5, 32)  X(R6, 32)  X(R7, 32)      \
+    X(R8, 32)  X(R9, 32)  X(R10, 32) X(R11, 32)     \
+    X(R12, 32) X(R13, 32)                           \
+    X(RET, 32) X(C0, 32)  X(C1, 32)                 \
+    X(T0, 64)  X(T1, 64)  X(PC, 32)  X(DOMAIN, 8)
+
+#define TSL_REG_SIGNAL_ENUM(name, width) REG_SIG_##name,
+typedef enum REG_SIGNAL {
+    TSL_REG_SIGNALS(TSL_REG_SIGNAL_ENUM)
+    REG_SIG_COUNT
+} REG_SIGNAL;
+#undef TSL_REG_SIGNAL_ENUM
+
+extern const char*   reg_signal_names[REG_SIG_COUNT];
+extern const uint8_t reg_signal_widths[REG_SIG_COUNT];
+
+// 上一次采样的值：首次采样时全部视为变化
+typedef struct REG_DELTA {
+    uint64_t prev[REG_SIG_COUNT];
+    uint8_t  valid;
+} REG_DELTA;
+
+struct CPU;
+
+uint32_t reg_delta_sample(REG_DELTA* rd, const struct CPU* cpu, uint64_t cur[REG_SIG_COUNT]);
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef SIGNAL_STORE_H
+#define SIGNAL_STORE_H
+
+#include <stdint.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+//=====================================================================================
+//   采样信号存储：列 0-13 为 R0-R13 的 bit0，当前/上一 FCLK 周期的值按 64 位字打包成两组位列数组，
+//   周期边界（仿真时间前进）交换两组的指针，上一周期的值无需复制。
+//   边沿类别（P/N/T/L/H/S）在周期内首次被读取时对全部列整块计算一次（SIMD），边沿类指令只查表。
+//=====================================================================================
+
+// 边沿类别，顺序与 edge_detect 的 func 编码（EDGE_P..EDGE_S）一致
+#define TSL_EDGE_CLASSES(X) X(P) X(N) X(T) X(L) X(H) X(S)
+
+#define TSL_EDGE_CLASS_ENUM(name) EDGE_CLASS_##name,
+typedef enum EDGE_CLASS {
+    TSL_EDGE_CLASSES(TSL_EDGE_CLASS_ENUM)
+    EDGE_CLASS_COUNT
+} EDGE_CLASS;
+#undef TSL_EDGE_CLASS_ENUM
+
+#define SIGNAL_STORE_REG_COLS   14                  // 列 0-13：R0-R13 的 bit0
+#define SIGNAL_STORE_REG_MASK   ((1ull << SIGNAL_STORE_REG_COLS) - 1)
+#define SIGNAL_STORE_WORDS      2                   // 每个位列数组的字数，按 SIMD 宽度（2 个字）取整
+
+typedef struct SIGNAL_STORE {
+    uint32_t  nwords;       // 每个位列数组的字数（SIGNAL_STORE_WORDS）
+    uint64_t* words;        // 两组采样值与各边沿类别的位列数组（一次分配）
+    uint64_t* cur;          // 本周期采样值（两组之一）
+    uint64_t* prev;         // 上一周期采样值（另一组）
+    uint64_t* cls;          // EDGE_CLASS_COUNT 个位列数组，第 c 类从 cls + c * nwords 开始
+    uint64_t  time;         // 当前周期的仿真时间（已执行指令数）
+    uint64_t  classified;   // cls 对应的 time，与 time 不等时读边沿前重新分类
+} SIGNAL_STORE;
+
+int      signal_store_init(SIGNAL_STORE* s);
+void     signal_store_classify(SIGNAL_STORE* s);
+void     signal_store_free(SIGNAL_STORE* s);
+
+// R0-R13 的 bit0 打包为一个字：SSE2 时每 4 个寄存器左移 31 位后取符号位
+static inline uint64_t signal_store_reg_bits(const uint32_t* regs) {
+#if defined(__SSE2__)
+    uint32_t bits = 0;
+    for (int i = 0; i < 16; i += 4) {
+        __m128i v = _mm_slli_epi32(_mm_loadu_si128((const __m128i*)(regs + i)), 31);
+        bits |= (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(v)) << i;
+    }
+    return bits & SIGNAL_STORE_REG_MASK;
+#else
+    uint64_t bits = 0;
+    for (int i = 0; i < SIGNAL_STORE_REG_COLS; i++)
+        bits |= (uint64_t)(regs[i] & 0x1) << i;
+    return bits;
+#endif
+}
+
+/*
+ * signal_store_cycle
+ * 作用：仿真时间前进到 now 时进入新的 FCLK 周期；同一时间重复调用不产生新周期。
+ * 行为：
+ *   - 交换 cur/prev 指针，本周期的采样成为 prev；
+ *   - 重新采样寄存器列（regs 须有 16 个元素）；
+ *   - 时间跳过若干周期时，跳过的周期内寄存器保持不变，prev 的寄存器列取当前值。
+ */
+static inline void signal_store_cycle(SIGNAL_STORE* s, const uint32_t* regs, uint64_t now) {
+    if (now == s->time)
+        return;
+    uint64_t* t = s->prev;
+    s->prev = s->cur;
+    s->cur = t;
+    s->cur[0] = signal_store_reg_bits(regs);
+    if (now != s->time + 1)
+        s->prev[0] = s->cur[0];
+    s->time = now;
+}
+
+// 读取第 col 列在本周期的边沿类别（0/1）
+static inline uint32_t signal_store_edge(SIGNAL_STORE* s, EDGE_CLASS c, uint32_t col) {
+    if (s->classified != s->time)
+        signal_store_classify(s);
+    return (uint32_t)(s->cls[(size_t)c * s->nwords + col / 64] >> (col % 64)) & 0x1;
+}
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef STIMULUS_H
+#define STIMULUS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+//=====================================================================================
+//   波形激励：从 VCD 文件按仿真时间流式回放信号值，作为 load 的信号来源。
+//   文件整体 mmap 只读映射，按时间推进增量解码；内存中只保留订阅信号的当前值。
+//=====================================================================================
+
+struct SIGNAL_SPLIT;
+
+// 订阅的信号：VCD 变量名与 signal_split.db 中的信号同名
+typedef struct STIM_SIGNAL {
+    uint64_t            id;     // VCD 标识符（不超过 8 字节时直接打包，否则取哈希）
+    const struct SIGNAL_SPLIT* sig;
+    uint32_t*           cur;    // 当前值，sig->nwords 个字（低位字在前）
+} STIM_SIGNAL;
+
+typedef struct STIMULUS {
+    uint8_t      enabled;       // --stimulus 打开
+    const char*  map;           // 文件映射
+    size_t       size;
+    size_t       pos;           // 下一个待解码的位置
+    size_t       released;      // 已解码并交还内核的前缀（MADV_DONTNEED），回放大文件时常驻内存不随进度增长
+    uint64_t     next_time;     // 下一段变化的时间戳（#t），UINT64_MAX 表示文件结束
+    STIM_SIGNAL* signals;
+    uint32_t     nsignals;
+    uint32_t*    slots;         // 标识符 -> signals 下标 + 1 的开放寻址表，0 为空
+    uint32_t     slot_mask;
+    uint32_t     nvars;         // 文件中的变量总数
+    uint32_t*    words;         // cur 的存储
+    uint64_t     changes;       // 已应用的值变化数
+} STIMULUS;
+
+int  stimulus_open(STIMULUS* s, const char* path);
+void stimulus_advance_to(STIMULUS* s, uint64_t now);
+void stimulus_close(STIMULUS* s);
+
+// 仿真时间到达下一段变化时才解码（load 前调用，开销为一次比较）
+static inline void stimulus_advance(STIMULUS* s, uint64_t now) {
+    if (now >= s->next_time)
+        stimulus_advance_to(s, now);
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef TIMER_SCHED_H
+#define TIMER_SCHED_H
+
+#include <stdint.h>
+
+//=====================================================================================
+//   定时器调度：定时器不逐条累加计数，而是记下计数起点，计数值由仿真时间（已执行指令数）推算；
+//   使能的定时器按下一次到期时间排成最小堆（事件队列），执行路径只比较当前时间与堆顶，
+//   到期时才弹出处理，每条指令的开销与定时器个数无关。
+//   时间约定：第 now 条指令执行之后 tick，timer_sched_* 的 now 为正在执行的指令的时间。
+//=====================================================================================
+
+typedef struct TIMER {
+    uint64_t threshold;     // 计时器阈值，当计数达到该值触发跳转
+    uint32_t target_pc;     // 触发后的目标PC（绝对地址，DRAM 基址空间），0 表示没有目标
+    uint8_t  enabled;
+    uint64_t base;          // 使能时第 now 条指令 tick 后的计数为 now - base；禁用时为冻结的计数
+    uint64_t deadline;      // 使能时下一次到期的 tick 时间
+    uint32_t slot;          // 在堆中的位置
+} TIMER;
+
+typedef struct TIMER_SCHED {
+    TIMER*    timers;
+    uint32_t  count;        // 定时器个数（timer_set 的 id 范围）
+    uint32_t* heap;         // 使能的定时器 id，按 (deadline, id) 排成最小堆
+    uint32_t  nheap;
+    uint64_t  next;         // 最早的到期时间，没有使能的定时器时为 UINT64_MAX
+} TIMER_SCHED;
+
+int  timer_sched_init(TIMER_SCHED* s, uint32_t count);
+void timer_sched_free(TIMER_SCHED* s);
+void timer_sched_reset(TIMER_SCHED* s, uint32_t id, uint64_t now);
+void timer_sched_enable(TIMER_SCHED* s, uint32_t id, uint64_t now);
+void timer_sched_disable(TIMER_SCHED* s, uint32_t id, uint64_t now);
+void timer_sched_config(TIMER_SCHED* s, uint32_t id, uint64_t now, uint64_t threshold, uint32_t target_pc);
+void timer_sched_restore(TIMER_SCHED* s, uint32_t id, uint64_t now, int enabled, uint64_t value);
+int  timer_sched_pop(TIMER_SCHED* s, uint64_t now);
+
+// 第 now 条指令 tick 之后是否有定时器到期
+static inline int timer_sched_due(const TIMER_SCHED* s, uint64_t now) {
+    return now >= s->next;
+}
+
+// 从 now 起接下来 n 条指令内是否没有定时器到期（基本块入口检查一次，成立则块内不再逐条检查）
+static inline int timer_sched_quiet(const TIMER_SCHED* s, uint64_t now, uint32_t n) {
+    return now + n < s->next;
+}
+
+// 第 now 条指令 tick 之后的计数值（dump_registers 显示的 T0/T1）
+static inline uint64_t timer_sched_value(const TIMER_SCHED* s, uint32_t id, uint64_t now) {
+    const TIMER* t = &s->timers[id];
+    return t->enabled ? now - t->base : t->base;
+}
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include "decode_cache.h"
+
+// 缓冲区容量（记录数）：写满后整块写入文件
+#define TRACE_BUF_RECORDS   (1u << 16)
+#define TRACE_MAGIC         "TSLTRACE"
+#define TRACE_VERSION       1
+
+// TraceRecord.reg 的特殊取值
+#define TRACE_REG_RET       16      // 返回地址寄存器（bl/ret）
+#define TRACE_REG_NONE      0xFF    // 未写寄存器
+
+// TraceRecord.flags
+#define TRACE_F_T0_EN       0x1     // 执行后 timer0 使能
+#define TRACE_F_T1_EN       0x2     // 执行后 timer1 使能
+
+//=====================================================================================
+//   二进制执行轨迹：每条已执行指令一条定长记录，由 tools/tsl_trace 离线还原为文本
+//=====================================================================================
+typedef struct TraceHeader {
+    char     magic[8];          // TRACE_MAGIC
+    uint32_t version;
+    uint32_t record_size;       // sizeof(TraceRecord)
+    char     image[240];        // 程序镜像路径，解码时据此定位 *.db
+} TraceHeader;
+
+typedef struct TraceRecord {
+    uint64_t raw;               // 原始指令
+    uint32_t pc;                // 指令地址
+    uint32_t next_pc;           // 执行后（含定时器跳转）的 PC
+    uint32_t value;             // 目标寄存器的新值
+    uint8_t  length;            // 指令字节数
+    uint8_t  reg;               // 目标寄存器 0-15 / TRACE_REG_RET / TRACE_REG_NONE
+    uint8_t  flags;             // TRACE_F_*
+    uint8_t  reserved;
+    uint64_t timer[2];          // 执行后的 T0/T1（与 dump_registers 显示一致）
+} TraceRecord;
+
+typedef struct TRACE {
+    uint8_t      enabled;       // --trace-file 打开
+    int          fd;
+    TraceRecord* buf;           // TRACE_BUF_RECORDS 条，写满后刷新并从头复用
+    uint32_t     count;         // 缓冲区中尚未写出的记录数
+    uint64_t     total;         // 已记录条数
+} TRACE;
+
+struct CPU;
+
+int  trace_open(TRACE* t, const char* path, const char* image);
+void trace_flush(TRACE* t);
+void trace_close(TRACE* t);
+void trace_record(TRACE* t, const struct CPU* cpu, const DecodedInst* d, uint32_t pc);
+uint8_t trace_dest_reg(const DecodedInst* d);
+
+#endif
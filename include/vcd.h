@@ -0,0 +1,28 @@
+#ifndef VCD_H
+#define VCD_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "reg_delta.h"
+
+// 输出缓冲区大小：写满后整块写入文件
+#define VCD_BUF_SIZE    (1u << 20)
+
+//=====================================================================================
+//   VCD 波形输出：寄存器、计数器、定时器、域与 PC，时间戳为已执行指令数（仿真周期）
+//=====================================================================================
+typedef struct VCD {
+    uint8_t   enabled;      // --vcd 打开
+    FILE*     fp;
+    char*     buf;
+    size_t    used;
+    REG_DELTA delta;        // 上一次写出的值，只输出变化
+} VCD;
+
+struct CPU;
+
+int  vcd_open(VCD* v, const char* path, const struct CPU* cpu);
+void vcd_sample(VCD* v, const struct CPU* cpu);
+void vcd_close(VCD* v);
+
+#endif
@@ -2,127 +2,209 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
+#include <getopt.h>
+#include <time.h>
 
 #include "include/cpu.h"
 #include "include/color.h"
+#include "include/loader.h"
+#include "include/log.h"
 
 /*
- * read_file
- * 作用：从文件读取数据并加载到CPU的DRAM中。
- * 行为：
- *   - 打开指定的二进制文件；
- *   - 读取文件内容到内存缓冲区；
- *   - 将缓冲区内容复制到CPU的DRAM中；
- *   - 关闭文件。
- * 示例：
- *   read_file(cpu, "program.bin") => 1024 (返回加载的字节数)
+ * usage
+ * 作用：打印命令行用法。
  */
-size_t read_file(CPU* cpu, char *filename) {
-    FILE *file = fopen(filename, "rb");
-    if (!file) {
-        printf("%sUnable to open file %s%s\n", ANSI_RED, filename, ANSI_RESET);
-        return 0;
-    }
-
-    if (fseek(file, 0, SEEK_END) != 0) { fclose(file); printf("%sSeek error%s\n", ANSI_RED, ANSI_RESET); return 0; }
-    unsigned long fileLen = ftell(file);
-    if (fileLen == (unsigned long)-1) { fclose(file); printf("%sTell error%s\n", ANSI_RED, ANSI_RESET); return 0; }
-    if (fseek(file, 0, SEEK_SET) != 0) { fclose(file); printf("%sSeek error%s\n", ANSI_RED, ANSI_RESET); return 0; }
-
-    if (fileLen == 0) {
-        printf("%sError: file is empty, nothing to load%s!\n", ANSI_RED, ANSI_RESET);
-        fclose(file);
-        return 0;
-    }
-
-    uint8_t *buffer = (uint8_t *)malloc(fileLen);
-    if (!buffer) { fclose(file); printf("%sMemory error%s\n", ANSI_RED, ANSI_RESET); return 0; }
-
-    size_t read_bytes = fread(buffer, 1, fileLen, file);
-    fclose(file);
-    if (read_bytes != fileLen) { printf("%sRead error (%zu/%lu)%s\n", ANSI_RED, read_bytes, fileLen, ANSI_RESET); free(buffer); return 0; }
-
-    printf("%s[MEMORY INFO]:%s", ANSI_BOLD, ANSI_RESET);
-    for (size_t i = 0; i < read_bytes; i++) {
-        if (i % 16 == 0) {
-            printf("\n   %4s%.8lx:%s ", ANSI_YELLOW, (unsigned long)i, ANSI_RESET);
-        }
-        printf("%s%02x%s ", ANSI_BOLD, buffer[i], ANSI_RESET);
-    }
-    printf("\n");
+static void usage(void) {
+    log_printf("%sUsage: tsl_cpu_emulator [--jit] [--log-level=quiet|summary|trace|full] [--trace-file=F] [--vcd=F] [--reg-dump=full|changes] [--dump-image] [--dram-size=N[K|M]|max] [--dbg-csr] [--stimulus=F] [--async-log[=block|drop]] [--log-deferred=F] <filename.bin>%s\n", ANSI_RED, ANSI_RESET);
+    log_printf("%s  --jit          compile hot basic blocks to x86-64 machine code%s\n", ANSI_RED, ANSI_RESET);
+    log_printf("%s  --log-level=L  quiet: send/trigger output and a final summary; summary: plus run events;%s\n", ANSI_RED, ANSI_RESET);
+    log_printf("%s                 trace: plus per-instruction disassembly; full: plus register dumps (default)%s\n", ANSI_RED, ANSI_RESET);
+    log_printf("%s  --trace-file=F record per-instruction trace to F (decode with tools/tsl_trace), log level capped at summary%s\n", ANSI_RED, ANSI_RESET);
+    log_printf("%s  --vcd=F        write register/counter/timer/domain/PC value changes to VCD file F, log level capped at summary%s\n", ANSI_RED, ANSI_RESET);
+    log_printf("%s  --reg-dump=M   full: print every register after each instruction (default); changes: only the changed ones%s\n", ANSI_RED, ANSI_RESET);
+    log_printf("%s  --dump-image   print a hex dump of the loaded image%s\n", ANSI_RED, ANSI_RESET);
+    log_printf("%s  --dram-size=S  DRAM size in bytes (K/M suffix, max = 56.8MB VU13P BRAM+URAM), default 32K; pages are allocated on first write%s\n", ANSI_RED, ANSI_RESET);
+    log_printf("%s  --dbg-csr      map the debug CSRs (DBG_CTRL/DBG_PC/DBG_BP_ADDR/DBG_TRACE_PTR) at 0xFFF000 (DBG_CSR_BASE) on the bus, readable with load; needs --dram-size <= 0xFFF000%s\n", ANSI_RED, ANSI_RESET);
+    log_printf("%s  --stimulus=F   replay signal values from VCD file F (names matched against signal_split.db), one time unit per executed instruction%s\n", ANSI_RED, ANSI_RESET);
+    log_printf("%s  --async-log[=P] write stdout from a background thread; P=block (default) waits when the buffer is full, drop discards and counts%s\n", ANSI_RED, ANSI_RESET);
+    log_printf("%s  --log-deferred=F write stdout as format IDs + raw arguments to F (format with tools/tsl_logfmt)%s\n", ANSI_RED, ANSI_RESET);
+}
 
-    size_t copy_bytes = read_bytes;
-    if (copy_bytes > (size_t)DRAM_SIZE) {
-        printf("%sWarning: file too large, truncating to %zu bytes%s\n", ANSI_YELLOW, (size_t)DRAM_SIZE, ANSI_RESET);
-        copy_bytes = (size_t)DRAM_SIZE;
-    }
-    memcpy(cpu->bus.dram.mem, buffer, copy_bytes);
-    printf("\n%sSuccessfully loaded %s (%zu bytes)%s!\n", ANSI_BOLD, filename, copy_bytes, ANSI_RESET);
-    free(buffer);
-    return copy_bytes;
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
 }
 
 /*
  * main
  * 作用：主函数，初始化CPU、读取文件并执行指令。
  * 行为：
- *   - 检查命令行参数，确保提供了一个二进制文件路径；
+ *   - 解析命令行选项（--jit、--log-level、--trace-file、--vcd、--reg-dump、--dump-image、--dram-size、--dbg-csr、--stimulus、--async-log、--log-deferred），确保提供了一个二进制文件路径；
  *   - 设置信息基础目录，支持直接传递文件路径；
- *   - 初始化CPU、寄存器和程序计数器；
- *   - 从文件读取指令并加载到DRAM中；
- *   - 进入主循环，执行指令直到PC返回0或触发异常；
+ *   - 初始化CPU、寄存器和程序计数器，按 --dram-size 建立 DRAM 页表；
+ *   - 将镜像文件映射为DRAM内容（--dump-image 时打印十六进制转储），为镜像建立解码缓存与基本块缓存；
+ *   - 进入主循环，执行指令直到PC返回0或触发异常；低于 full 级别时打印结束汇总；
  *   - 清理资源，包括关闭文件和释放内存。
  * 示例：
  *   emulator program.bin => 无返回值
+ *   emulator --jit program.bin => 热点块编译执行，输出相同
+ *   emulator --log-level=quiet program.bin => 只输出 send/trigger 与汇总
+ *   emulator --trace-file=run.trc program.bin => 逐条指令写入二进制轨迹，tools/tsl_trace 还原
+ *   emulator --vcd=run.vcd program.bin => 寄存器变化写入 VCD，可用 GTKWave 等查看
+ *   emulator --reg-dump=changes program.bin => 每条指令后只打印变化的寄存器
+ *   emulator --stimulus=capture.vcd program.bin => load 取到的信号值随仿真时间按波形变化
+ *   emulator --async-log program.bin => 输出相同，由后台线程写 stdout
+ *   emulator --log-deferred=run.logd program.bin => 输出写成事件文件，tools/tsl_logfmt 还原
  */
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        printf("%sUsage: tsl_cpu_emulator <filename.bin>%s\n", ANSI_RED, ANSI_RESET);
+    static const struct option long_opts[] = {
+        { "jit",       no_argument,       NULL, 'j' },
+        { "log-level",  required_argument, NULL, 'l' },
+        { "trace-file", required_argument, NULL, 't' },
+        { "async-log",  optional_argument, NULL, 'a' },
+        { "log-deferred", required_argument, NULL, 'd' },
+        { "vcd",        required_argument, NULL, 'v' },
+        { "reg-dump",   required_argument, NULL, 'r' },
+        { "dump-image", no_argument,       NULL, 'm' },
+        { "dram-size",  required_argument, NULL, 's' },
+        { "dbg-csr",    no_argument,       NULL, 'c' },
+        { "stimulus",   required_argument, NULL, 'S' },
+        { NULL, 0, NULL, 0 }
+    };
+    int use_jit = 0;
+    const char* trace_path = NULL;
+    const char* vcd_path = NULL;
+    int reg_dump_changes = 0;
+    int dump_image = 0;
+    uint64_t dram_size = DRAM_DEFAULT_SIZE;
+    int dbg_csr = 0;
+    const char* stimulus_path = NULL;
+    int async_log = 0;
+    LOG_BACKPRESSURE policy = LOG_BP_BLOCK;
+    const char* deferred_path = NULL;
+    LOG_LEVEL level = LOG_FULL;
+    int opt;
+    while ((opt = getopt_long(argc, argv, "", long_opts, NULL)) != -1) {
+        switch (opt) {
+            case 'j': use_jit = 1; break;
+            case 'l':
+                if (!log_level_parse(optarg, &level)) {
+                    log_printf("%sUnknown log level: %s%s\n", ANSI_RED, optarg, ANSI_RESET);
+                    usage();
+                    exit(1);
+                }
+                break;
+            case 't': trace_path = optarg; break;
+            case 'v': vcd_path = optarg; break;
+            case 'm': dump_image = 1; break;
+            case 'c': dbg_csr = 1; break;
+            case 'S': stimulus_path = optarg; break;
+            case 's':
+                if (!dram_parse_size(optarg, &dram_size)) {
+                    log_printf("%sInvalid DRAM size: %s%s\n", ANSI_RED, optarg, ANSI_RESET);
+                    usage();
+                    exit(1);
+                }
+                break;
+            case 'r':
+                if (strcmp(optarg, "full") != 0 && strcmp(optarg, "changes") != 0) {
+                    log_printf("%sUnknown register dump mode: %s%s\n", ANSI_RED, optarg, ANSI_RESET);
+                    usage();
+                    exit(1);
+                }
+                reg_dump_changes = strcmp(optarg, "changes") == 0;
+                break;
+            case 'd': deferred_path = optarg; break;
+            case 'a':
+                async_log = 1;
+                if (optarg && !log_backpressure_parse(optarg, &policy)) {
+                    log_printf("%sUnknown async log policy: %s%s\n", ANSI_RED, optarg, ANSI_RESET);
+                    usage();
+                    exit(1);
+                }
+                break;
+            default:  usage(); exit(1);
+        }
+    }
+    // 逐条指令的文本由轨迹解码工具输出，波形记录时不逐条打印
+    if ((trace_path || vcd_path) && level > LOG_SUMMARY)
+        level = LOG_SUMMARY;
+    set_log_level(level);
+    if (deferred_path && !log_deferred_open(deferred_path))
+        exit(1);
+    if (async_log)
+        log_async_start(policy);
+    if (argc - optind != 1) {
+        usage();
         exit(1);
     }
+    char* filename = argv[optind];
 
-    printf("\n%s==================================================================================%s\n", ANSI_BOLD_WHITE, ANSI_RESET);
-    printf("%s                          Emulator exec start!                        %s\n", ANSI_BOLD_GREEN, ANSI_RESET);
-    printf("%s==================================================================================%s\n", ANSI_BOLD_WHITE, ANSI_RESET);
+    if (LOG_ENABLED(LOG_SUMMARY)) {
+        log_printf("\n%s==================================================================================%s\n", ANSI_BOLD_WHITE, ANSI_RESET);
+        log_printf("%s                          Emulator exec start!                        %s\n", ANSI_BOLD_GREEN, ANSI_RESET);
+        log_printf("%s==================================================================================%s\n", ANSI_BOLD_WHITE, ANSI_RESET);
+    }
 
     // Set info base dir using input path (support passing file path directly)
-    set_info_base(argv[1]);
+    set_info_base(filename);
 
     // Initialize cpu, registers and program counter
     struct CPU cpu;
-    cpu_init(&cpu);
+    if (!cpu_init(&cpu, dram_size)) {
+        fprintf(stderr, "%s[cpu] init failed%s\n", ANSI_RED, ANSI_RESET);
+        cpu_cleanup(&cpu);
+        return 1;
+    }
+    if (dbg_csr && !dbg_csr_attach(&cpu.dbg, &cpu.bus, &cpu.pc)) {
+        fprintf(stderr, "%s[dbg_csr] attach failed%s\n", ANSI_RED, ANSI_RESET);
+        cpu_cleanup(&cpu);
+        return 1;
+    }
+    cpu.dump_changes = (uint8_t)reg_dump_changes;
 
     // Read input file
-    if (read_file(&cpu, argv[1]) == 0) {
+    size_t image_size = read_file(&cpu, filename, dump_image);
+    if (image_size == 0) {
         cpu_cleanup(&cpu);
         return 0;
     }
 
-    // cpu loop
-    while (1) {
-        // inst length
-        uint8_t inst_length;
-
-        // fetch
-        uint64_t inst = cpu_fetch(&cpu, &inst_length);
-
-        // execute
-        if (!cpu_execute(&cpu, inst, inst_length))
-            break;
+    if (trace_path && !trace_open(&cpu.trace, trace_path, filename)) {
+        cpu_cleanup(&cpu);
+        return 1;
+    }
+    if (vcd_path && !vcd_open(&cpu.vcd, vcd_path, &cpu)) {
+        cpu_cleanup(&cpu);
+        return 1;
+    }
+    if (stimulus_path && !stimulus_open(&cpu.stim, stimulus_path)) {
+        cpu_cleanup(&cpu);
+        return 1;
+    }
 
-        // dump registers
-        dump_registers(&cpu);
+    // Decode and basic-block caches over the loaded image
+    cpu_init_caches(&cpu, image_size);
+    if (use_jit)
+        cpu_enable_jit(&cpu);
 
-        if (cpu.pc == 0)
-            break;
-    }
+    // cpu loop: fetch -> execute -> dump registers (or record trace / waveform), until pc returns to 0
+    double start = now_seconds();
+    cpu_run(&cpu);
+    if (!LOG_ENABLED(LOG_FULL))
+        cpu_print_summary(&cpu, now_seconds() - start);
 
     // 清理资源
     cpu_cleanup(&cpu);
 
-    printf("\n%s==================================================================================%s\n", ANSI_BOLD_WHITE, ANSI_RESET);
-    printf("%s                          Emulator exec successfully!                        %s\n", ANSI_BOLD_GREEN, ANSI_RESET);
-    printf("%s==================================================================================%s\n", ANSI_BOLD_WHITE, ANSI_RESET);
+    if (LOG_ENABLED(LOG_SUMMARY)) {
+        log_printf("\n%s==================================================================================%s\n", ANSI_BOLD_WHITE, ANSI_RESET);
+        log_printf("%s                          Emulator exec successfully!                        %s\n", ANSI_BOLD_GREEN, ANSI_RESET);
+        log_printf("%s==================================================================================%s\n", ANSI_BOLD_WHITE, ANSI_RESET);
+    }
 
+    log_deferred_close();
+    log_async_stop();
     return 0;
 }
@@ -0,0 +1,84 @@
+#!/bin/bash
+# 差分检查：examples/ 下每个 .bin 在各日志级别分别以解释器与 --jit 运行，比较输出
+#   用法：scripts/jit_diff.sh [emulator] [examples 目录] [CORE=switch 构建的 emulator]
+#   - 输出中的耗时与速率（随运行变化）比较前去掉；空转跳过的指令数（skipped）保留，两者应相同；
+#   - 不会自行结束的程序由 timeout 截断，只比较两者都输出了的前缀；
+#   - 程序目录下有 stimulus.vcd 时两者都以 --stimulus 回放；
+#   - 有 <程序>.expect 时，解释器与 --jit 在 summary 级别的 stdout（去掉颜色与耗时）须与其一致，
+#     固定程序的结果（最终寄存器、指令数等），不只比较两者之间是否相同；输出中的程序目录去掉，与调用路径无关；另以 --vcd 运行（观察实例
+#     不做空转跳过），去掉 skipped 后也须一致，空转跳过与逐条执行的结果相同；给出 switch 内核的
+#     emulator 时它的输出同样核对（switch 内核在单条指令处检测空转，跳过的条数可以不同，比较时去掉）；
+#   - 有差异时打印对应的程序与级别，退出码为 1。
+
+EMU=${1:-./emulator}
+DIR=${2:-examples}
+SWITCH_EMU=$3
+TIMEOUT=${TIMEOUT:-5}
+LIMIT=${LIMIT:-4000000}
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+# run <输出文件> <参数...>：返回 0 表示程序在限时内结束且输出未被截断
+run() {
+    local out=$1
+    shift
+    timeout "$TIMEOUT" "$EMU" "$@" 2>&1 | head -c "$LIMIT" | sed -e 's/time:[0-9.]*s ([0-9.]* Minst\/s)//' > "$out"
+    [ "${PIPESTATUS[0]}" -ne 124 ] && [ "$(stat -c %s "$out")" -lt "$LIMIT" ]
+}
+
+# expect <emulator> <程序> <说明> <skip> <参数...>：summary 级别运行，stdout 与 <程序>.expect 比较；
+#   skip 为 0 时比较前去掉两边的 skipped（不做空转跳过的运行，或跳过条数不必相同的 switch 内核）
+expect() {
+    local emu=$1 bin=$2 what=$3 skip=$4
+    shift 4
+    timeout "$TIMEOUT" "$emu" --log-level=summary "$@" "$bin" 2>/dev/null \
+        | sed -e 's/\x1b\[[0-9;]*m//g' -e 's/ time:[0-9.]*s ([0-9.]* Minst\/s)//' -e "s|$(dirname "$bin")/||g" > "$TMP/out"
+    if [ "$skip" = 1 ]; then
+        cp "${bin%.bin}.expect" "$TMP/want"
+    else
+        sed -i 's/ skipped:[0-9]*//' "$TMP/out"
+        sed 's/ skipped:[0-9]*//' "${bin%.bin}.expect" > "$TMP/want"
+    fi
+    if diff "$TMP/out" "$TMP/want" > "$TMP/expect"; then
+        echo "[jit_diff] ok: $bin matches ${bin%.bin}.expect ($what)"
+    else
+        echo "[jit_diff] EXPECT: $bin differs from ${bin%.bin}.expect ($what)"
+        sed 's/^/    /' "$TMP/expect"
+        fail=1
+    fi
+}
+
+fail=0
+for bin in "$DIR"/*/*.bin; do
+    stim=()
+    [ -f "$(dirname "$bin")/stimulus.vcd" ] && stim=(--stimulus="$(dirname "$bin")/stimulus.vcd")
+    for level in quiet summary trace full; do
+        run "$TMP/interp" --log-level=$level "${stim[@]}" "$bin"; done_a=$?
+        run "$TMP/jit" --log-level=$level --jit "${stim[@]}" "$bin"; done_b=$?
+        a=$(stat -c %s "$TMP/interp")
+        b=$(stat -c %s "$TMP/jit")
+        n=$(( a < b ? a : b ))
+        if [ $done_a -eq 0 ] && [ $done_b -eq 0 ] && [ "$a" -ne "$b" ]; then
+            echo "[jit_diff] DIFF (length $a/$b): $bin --log-level=$level"
+            fail=1
+        elif ! cmp -s <(head -c "$n" "$TMP/interp") <(head -c "$n" "$TMP/jit"); then
+            echo "[jit_diff] DIFF: $bin --log-level=$level"
+            cmp <(head -c "$n" "$TMP/interp") <(head -c "$n" "$TMP/jit") | sed 's/^/    /'
+            fail=1
+        else
+            echo "[jit_diff] ok: $bin --log-level=$level"
+        fi
+    done
+    if [ -f "${bin%.bin}.expect" ]; then
+        expect "$EMU" "$bin" interpreter 1 "${stim[@]}"
+        expect "$EMU" "$bin" jit 1 --jit "${stim[@]}"
+        expect "$EMU" "$bin" "interpreter, no skip" 0 --vcd="$TMP/run.vcd" "${stim[@]}"
+        expect "$EMU" "$bin" "jit, no skip" 0 --jit --vcd="$TMP/run.vcd" "${stim[@]}"
+        if [ -n "$SWITCH_EMU" ]; then
+            expect "$SWITCH_EMU" "$bin" "switch core" 0 "${stim[@]}"
+            expect "$SWITCH_EMU" "$bin" "switch core, no skip" 0 --vcd="$TMP/run.vcd" "${stim[@]}"
+        fi
+    fi
+done
+exit $fail
@@ -0,0 +1,191 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/cpu.h"
+#include "../include/block_cache.h"
+
+/*
+ * block_cache_init
+ * 作用：为程序镜像分配基本块索引表。
+ * 行为：按入口 PC 建立指针数组，块在首次到达该入口时构建。
+ * 返回：成功返回1，分配失败返回0（此时不使用块缓存）。
+ */
+int block_cache_init(BLOCK_CACHE* bc, uint64_t base, uint64_t size) {
+    block_cache_free(bc);
+    if (size == 0) return 1;
+    bc->by_pc = (BasicBlock**)calloc(size, sizeof(BasicBlock*));
+    if (!bc->by_pc) {
+        fprintf(stderr, "[cpu][block_cache] alloc failed: %lu entries\n", (unsigned long)size);
+        return 0;
+    }
+    bc->base = base;
+    bc->size = size;
+    return 1;
+}
+
+/*
+ * block_cache_free
+ * 作用：释放所有基本块与索引表。
+ */
+void block_cache_free(BLOCK_CACHE* bc) {
+    if (bc->by_pc) {
+        for (uint64_t i = 0; i < bc->size; i++) free(bc->by_pc[i]);
+        free(bc->by_pc);
+    }
+    bc->by_pc = NULL;
+    bc->base = 0;
+    bc->size = 0;
+}
+
+// 控制转移指令：作为块的最后一条指令
+static int is_block_terminator(uint16_t op) {
+    return op == INST_OP_JMP || op == INST_OP_BL || op == INST_OP_RET ||
+           (op >= INST_OP_JMPC_EQ && op <= INST_OP_JMPC_UNKNOWN);
+}
+
+// 修改定时器的指令：块的定时器预算在入口处计算，这类指令单独成块并逐条 tick
+static int is_timer_op(uint16_t op) {
+    return op >= INST_OP_TIMER_RESET && op <= INST_OP_TIMER_INVALID;
+}
+
+static int is_jmpc_compare(uint16_t op) {
+    return op >= INST_OP_JMPC_EQ && op <= INST_OP_JMPC_LE;
+}
+
+
+// 读信号值的指令：load 与 send（display 模板代入当前信号值）须先把波形激励推进到本周期
+static int reads_signals(uint16_t op) {
+    return op == INST_OP_LOAD || (op >= INST_OP_SEND_DISPLAY && op <= INST_OP_SEND_UNKNOWN);
+}
+
+// 读边沿采样的指令：比较本周期与前一周期的采样
+static int reads_edges(uint16_t op) {
+    return (op >= INST_OP_EDGE_P && op <= INST_OP_EDGE_S) || op == INST_OP_JMPC_POS || op == INST_OP_JMPC_NEG;
+}
+
+/*
+ * fuse_pair
+ * 作用：判断相邻两条指令能否融合为超级指令。
+ * 规则：第二条指令读取第一条指令的目标寄存器。
+ *   - load rX       + bit_slice rY rX   => LOAD_SLICE
+ *   - load rX       + jmpc rX ?? rY     => LOAD_JMPC
+ *   - bit_slice rX  + edge_detect rY rX => SLICE_EDGE
+ *   - mov rX, imm   + jmpc rY ?? rX     => MOVI_JMPC
+ * 返回：超级指令编号，不能融合返回 0。
+ */
+static uint16_t fuse_pair(const DecodedInst* a, const DecodedInst* b) {
+    if (a->op == INST_OP_LOAD && b->op == INST_OP_BIT_SLICE && b->rs1 == a->rd)
+        return SUPER_OP_LOAD_SLICE;
+    if (a->op == INST_OP_LOAD && is_jmpc_compare(b->op) && (b->rs1 == a->rd || b->rs2 == a->rd))
+        return SUPER_OP_LOAD_JMPC;
+    if (a->op == INST_OP_BIT_SLICE && b->op >= INST_OP_EDGE_P && b->op <= INST_OP_EDGE_X && b->rs1 == a->rd)
+        return SUPER_OP_SLICE_EDGE;
+    if (a->op == INST_OP_MOVI && is_jmpc_compare(b->op) && (b->rs1 == a->rd || b->rs2 == a->rd))
+        return SUPER_OP_MOVI_JMPC;
+    return 0;
+}
+
+/*
+ * block_build
+ * 作用：从入口 PC 构建基本块。
+ * 行为：
+ *   - 顺序解码指令，遇控制转移指令（含）、timer_set（不含）、非法指令或达到上限时结束；
+ *   - 入口即为 timer_set 时单独成块，并标记为逐条检查定时器；
+ *   - 全部指令都没有副作用时标记为 pure（空转检测只跨越这样的块）；
+ *   - 信号存储懒采样：只有读信号或边沿的指令及其前一条指令开始前采样。块的最后一条不是控制转移时，
+ *     其后（下一块的入口）可能是边沿类指令，也要采样；控制转移不改 R0-R13，下一块入口的边沿类指令
+ *     按时间跳跃补齐的前一周期采样（等于当前寄存器）与逐条采样一致；
+ *   - 相邻指令按 fuse_pair 规则融合为超级指令。
+ * 返回：成功返回新块；入口指令无法解码返回 NULL（由调用方走单步路径报错）。
+ */
+static BasicBlock* block_build(CPU* cpu, uint64_t pc) {
+    const DecodedInst* insts[BLOCK_MAX_INSTS];
+    uint8_t sample[BLOCK_MAX_INSTS];
+    uint32_t n = 0;
+    uint64_t cur = pc;
+    uint8_t exact = 0, pure = 1;
+
+    while (n < BLOCK_MAX_INSTS) {
+        const DecodedInst* d = cpu_decode_at(cpu, cur);
+        if (!d) break;
+        if (is_timer_op(d->op)) {
+            if (n == 0) {
+                insts[n++] = d;
+                cur += d->length;
+                exact = 1;
+            }
+            break;
+        }
+        insts[n++] = d;
+        cur += d->length;
+        pure &= inst_side_effect_free(d->op);
+        if (is_block_terminator(d->op)) break;
+    }
+    if (n == 0) return NULL;
+
+    for (uint32_t i = 0; i < n; i++)
+        sample[i] = reads_signals(insts[i]->op) || reads_edges(insts[i]->op) ||
+                    (i + 1 < n && reads_edges(insts[i + 1]->op));
+    if (!is_block_terminator(insts[n - 1]->op)) {
+        const DecodedInst* next = cpu_decode_at(cpu, cur);
+        sample[n - 1] |= !next || reads_edges(next->op);
+    }
+
+    BasicBlock* b = (BasicBlock*)malloc(sizeof(BasicBlock) + (n + 1) * sizeof(BlockOp));
+    if (!b) return NULL;
+    b->start_pc = pc;
+    b->end_pc = cur;
+    b->ninsts = n;
+    b->exact = exact;
+    b->pure = pure && !exact;
+    b->generation = cpu->icache.generation;
+    b->hits = 0;
+    b->jit_nops = 0;
+    b->jit_ninsts = 0;
+    b->jit_code = NULL;
+    b->jit_chain = NULL;
+    b->jit_nexits = 0;
+    b->jit_next[0] = b->jit_next[1] = NULL;
+
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        uint16_t super = i + 1 < n ? fuse_pair(insts[i], insts[i + 1]) : 0;
+        b->ops[k].a = insts[i];
+        b->ops[k].sample = sample[i] ? BLOCK_SAMPLE_A : 0;
+        if (super) {
+            b->ops[k].op = super;
+            b->ops[k].b = insts[++i];
+            b->ops[k].sample |= sample[i] ? BLOCK_SAMPLE_B : 0;
+        } else {
+            b->ops[k].op = insts[i]->op;
+            b->ops[k].b = NULL;
+        }
+        k++;
+    }
+    b->ops[k].op = BLOCK_OP_END;
+    b->ops[k].sample = 0;
+    b->ops[k].a = b->ops[k].b = NULL;
+    return b;
+}
+
+/*
+ * block_cache_get
+ * 作用：取入口 PC 处的基本块，必要时构建。
+ * 行为：
+ *   - PC 超出镜像范围返回 NULL；
+ *   - 已缓存且解码缓存代数未变化时直接返回；
+ *   - 否则（首次到达或内存被写过）重新构建并缓存；旧块的本机代码留在 JIT 代码区中不再引用。
+ */
+BasicBlock* block_cache_get(BLOCK_CACHE* bc, CPU* cpu, uint64_t pc) {
+    uint64_t off = pc - bc->base;
+    if (off >= bc->size) return NULL;
+
+    BasicBlock* b = bc->by_pc[off];
+    if (b && b->generation == cpu->icache.generation)
+        return b;
+
+    free(b);
+    b = block_build(cpu, pc);
+    bc->by_pc[off] = b;
+    return b;
+}
@@ -1,15 +1,96 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "bus.h"
+#include "decode_cache.h"
+#include "color.h"
+
+/*
+ * bus_register_device
+ * 作用：把设备挂到总线的 [base, base+size) 区间上。
+ * 行为：
+ *   - 按 base 插入有序设备表并更新区间包络；
+ *   - 区间为空或与已有设备重叠时打印错误，不注册。
+ * 返回：成功返回1，失败返回0。
+ * 示例：
+ *   bus_register_device(bus, &(BUS_DEVICE){ "dbg_csr", 0xFFF000, 0x14, ... }) => 1
+ */
+int bus_register_device(BUS* bus, const BUS_DEVICE* dev) {
+    if (dev->size == 0 || !dev->read) {
+        fprintf(stderr, "%s[bus][device] invalid device %s%s\n", ANSI_RED, dev->name, ANSI_RESET);
+        return 0;
+    }
+    uint32_t pos = 0;
+    while (pos < bus->ndevices && bus->devices[pos].base < dev->base)
+        pos++;
+    const BUS_DEVICE* prev = pos > 0 ? &bus->devices[pos - 1] : NULL;
+    const BUS_DEVICE* next = pos < bus->ndevices ? &bus->devices[pos] : NULL;
+    if ((prev && prev->base + prev->size > dev->base) || (next && dev->base + dev->size > next->base)) {
+        fprintf(stderr, "%s[bus][device] %s at 0x%08lx overlaps %s%s\n", ANSI_RED, dev->name,
+                (unsigned long)dev->base, (prev && prev->base + prev->size > dev->base) ? prev->name : next->name, ANSI_RESET);
+        return 0;
+    }
+
+    BUS_DEVICE* devices = (BUS_DEVICE*)realloc(bus->devices, (bus->ndevices + 1) * sizeof(BUS_DEVICE));
+    if (!devices) {
+        fprintf(stderr, "%s[bus][device] out of memory%s\n", ANSI_RED, ANSI_RESET);
+        return 0;
+    }
+    memmove(&devices[pos + 1], &devices[pos], (bus->ndevices - pos) * sizeof(BUS_DEVICE));
+    devices[pos] = *dev;
+    bus->devices = devices;
+    bus->ndevices++;
+    bus->io_lo = devices[0].base;
+    bus->io_hi = devices[bus->ndevices - 1].base + devices[bus->ndevices - 1].size;
+    return 1;
+}
+
+/*
+ * bus_find_device
+ * 作用：在有序设备表中二分查找包含 addr 的设备。
+ * 返回：设备，未映射到设备时返回 NULL。
+ */
+const BUS_DEVICE* bus_find_device(const BUS* bus, uint64_t addr) {
+    uint32_t lo = 0, hi = bus->ndevices;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        const BUS_DEVICE* dev = &bus->devices[mid];
+        if (addr < dev->base)
+            hi = mid;
+        else if (addr >= dev->base + dev->size)
+            lo = mid + 1;
+        else
+            return dev;
+    }
+    return NULL;
+}
+
+/*
+ * bus_free_devices
+ * 作用：清空设备表（设备自身的状态由注册方管理）。
+ */
+void bus_free_devices(BUS* bus) {
+    free(bus->devices);
+    bus->devices = NULL;
+    bus->ndevices = 0;
+    bus->io_lo = bus->io_hi = 0;
+}
 
 /*
  * bus_load
  * 作用：从总线加载数据。
  * 行为：
- *   - 调用 DRAM 加载函数，从 DRAM 中读取数据；
+ *   - 地址落在设备区间内时调用设备的 read 回调；
+ *   - 否则调用 DRAM 加载函数，从 DRAM 中读取数据；
  *   - 返回读取到的数据。
  * 示例：
  *   bus_load(bus, 0x00001000, 32) => 0x10001111000050ee000060ff000011f1
  */
 uint64_t bus_load(BUS* bus, uint64_t addr, uint64_t size) {
+    const BUS_DEVICE* dev = bus_io_device(bus, addr);
+    if (dev)
+        return dev->read(dev->ctx, addr - dev->base, size);
     return dram_load(&(bus->dram), addr, size);
 }
 
@@ -17,11 +98,20 @@ uint64_t bus_load(BUS* bus, uint64_t addr, uint64_t size) {
  * bus_store
  * 作用：向总线存储数据。
  * 行为：
- *   - 调用 DRAM 存储函数，将数据写入 DRAM；
+ *   - 地址落在设备区间内时调用设备的 write 回调（只读设备忽略写入）；
+ *   - 否则调用 DRAM 存储函数，将数据写入 DRAM，并失效写入区间对应的解码缓存行；
  *   - 无返回值。
  * 示例：
  *   bus_store(bus, 0x00001000, 32, 0x10001111000050ee000060ff000011f1) => 无返回值
  */
 void bus_store(BUS* bus, uint64_t addr, uint64_t size, uint64_t value) {
+    const BUS_DEVICE* dev = bus_io_device(bus, addr);
+    if (dev) {
+        if (dev->write)
+            dev->write(dev->ctx, addr - dev->base, size, value);
+        return;
+    }
     dram_store(&(bus->dram), addr, size, value);
+    if (bus->icache)
+        decode_cache_invalidate(bus->icache, addr, size / 8);
 }
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include "../include/color.h"
+#include "../include/log.h"
 
 
 static int g_ansi_enabled = 1;
@@ -10,5 +11,5 @@ void set_ansi_color_enabled(int enabled) {
 
 void print_color(const char* code) {
     if (g_ansi_enabled)
-        printf("%s", code);
+        log_printf("%s", code);
 }
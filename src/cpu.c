@@ -10,14 +10,29 @@
 #include "../include/dram.h"
 #include "../include/info_db.h"
 #include "../include/color.h"
+#include "../include/log.h"
+
+// 逐条执行路径上的公共步骤：GCC 下强制内联，线程化内核的每个标签各展开一份，不经过函数调用
+#if defined(__GNUC__)
+#define CPU_HOT_INLINE static inline __attribute__((always_inline))
+#else
+#define CPU_HOT_INLINE static inline
+#endif
 
 //=====================================================================================
 //   CPU Initialization
 //=====================================================================================
 
-void cpu_init(CPU *cpu) {
-    // 显式将整个 CPU 结构体清零（包括 DRAM 和寄存器）
+/*
+ * cpu_init
+ * 作用：清零 CPU 并建立 DRAM、采样信号存储、定时器与信息表。
+ * 返回：成功返回1；DRAM 大小越界或内存不足时（已打印错误）返回0，此时仍须调用 cpu_cleanup。
+ */
+int cpu_init(CPU *cpu, uint64_t dram_size) {
+    // 显式将整个 CPU 结构体清零（包括寄存器），DRAM 为单独分配的稀疏页表
     memset(cpu, 0, sizeof(CPU));
+    if (!dram_init(&cpu->bus.dram, dram_size))
+        return 0;
 
     // 初始化通用寄存器
     for (int i = 0; i < 14; i++) {
@@ -26,8 +41,9 @@ void cpu_init(CPU *cpu) {
     cpu->ret_reg = 0;           // 初始化返回地址寄存器
     cpu->pc = DRAM_BASE;        // Set program counter to the base address
 
-    // 初始化前一个周期的寄存器值
-    memset(cpu->prev_regs, 0, sizeof(cpu->prev_regs));
+    // 初始化采样信号存储（寄存器列的当前/上一周期值均为 0）
+    if (!signal_store_init(&cpu->sig))
+        return 0;
 
     // 初始化域相关寄存器
     cpu->domain = 0;
@@ -36,26 +52,21 @@ void cpu_init(CPU *cpu) {
     cpu->regs[14] = 0;
     cpu->regs[15] = 0;
 
-    // 初始化定时器相关寄存器
-    for (int i = 0; i < 2; i++) {
-        cpu->timer[i] = 0;
-        cpu->timer_enabled[i] = 0;
-        cpu->timer_threshold[i] = 0;  // 定时器i的阈值
-        cpu->timer_target_pc[i] = 0;  // 定时器i的目标PC
-    }   
+    // 初始化定时器（均为禁用、计数 0、没有目标）
+    if (!timer_sched_init(&cpu->timers, CPU_TIMER_COUNT))
+        return 0;
 
     // 初始化所有信息表
     info_db_init_all(cpu);
+    return 1;
 }
 
 /*
- * get_inst_size
- * 作用：根据操作码获取指令的字节数。
- * 行为：
- *   - 根据操作码判断指令的字节数；
- *   - 返回指令的字节数。
+ * inst_size_of
+ * 作用：根据操作码与PC处的8字节内容判断指令字节数（不打印日志）。
+ * 返回：指令字节数；未知操作码返回0。
  */
-uint8_t get_inst_size(uint8_t opcode, CPU *cpu) {
+static uint8_t inst_size_of(uint8_t opcode, uint64_t inst) {
     if (opcode == trigger || opcode == ret)
         return 1;
     else if (opcode == trigger_pos || opcode == jmp || opcode == bl || opcode == edge_detect || opcode == domain_set || opcode == send)
@@ -65,8 +76,6 @@ uint8_t get_inst_size(uint8_t opcode, CPU *cpu) {
     else if (opcode == timer_set)
         return 8;
     else if (opcode == mov) {
-        // 需要读取更多字节来判断是2字节MOV还是8字节MOVI
-        uint64_t inst = bus_load(&(cpu->bus), cpu->pc, 64); // 读取8字节
         // 检查是否是2字节MOV（寄存器到寄存器）
         // 条件：高48位全为0，且func[11]=1
         if ((inst >> 16) == 0 && ((inst >> 11) & 0x1) == 1) {
@@ -75,10 +84,25 @@ uint8_t get_inst_size(uint8_t opcode, CPU *cpu) {
             return 8;  // 8字节MOVI
         }
     }
-    else {
+    return 0;
+}
+
+/*
+ * get_inst_size
+ * 作用：根据操作码获取指令的字节数。
+ * 行为：
+ *   - 根据操作码判断指令的字节数，MOV 需要读取8字节判断是2字节MOV还是8字节MOVI；
+ *   - 返回指令的字节数，未知操作码打印错误并返回0。
+ */
+uint8_t get_inst_size(uint8_t opcode, CPU *cpu) {
+    uint64_t inst = 0;
+    if (opcode == mov)
+        inst = bus_load(&(cpu->bus), cpu->pc, 64); // 读取8字节
+
+    uint8_t size = inst_size_of(opcode, inst);
+    if (size == 0)
         fprintf(stderr, "%s[cpu][inst_size] unknown opcode 0x%x%s\n", ANSI_RED, opcode, ANSI_RESET);
-        return 0;
-    }
+    return size;
 }
 
 /*
@@ -104,7 +128,8 @@ uint8_t getInstLength(CPU *cpu) {
  * 作用：从CPU总线获取指令。
  * 行为：
  *   - 根据当前PC值，从 DRAM 中读取指令；
- *   - 更新PC值为下一条指令的地址；
+ *   - PC 之后 8 字节都在 DRAM 内时走快速路径：一次 64 位读取同时得到操作码与指令，不经过检查路径；
+ *   - 靠近 DRAM 末尾时走总线的检查路径，保留越界诊断；
  *   - 返回读取到的指令。
  */
 uint64_t cpu_fetch(CPU *cpu, uint8_t *inst_length) {
@@ -113,18 +138,112 @@ uint64_t cpu_fetch(CPU *cpu, uint8_t *inst_length) {
         fprintf(stderr, "%s[cpu][fetch] NULL inst_length ptr!%s\n", ANSI_RED, ANSI_RESET);
         return 0;
     }
+    if (cpu->pc + DECODE_MAX_INST_LEN <= cpu->bus.dram.size) {
+        uint64_t inst = dram_fast_load_64(&cpu->bus.dram, cpu->pc);
+        uint8_t opcode = (inst >> 60) & 0xF;
+        *inst_length = inst_size_of(opcode, inst);
+        if (*inst_length == 0) {
+            fprintf(stderr, "%s[cpu][inst_size] unknown opcode 0x%x%s\n", ANSI_RED, opcode, ANSI_RESET);
+            fprintf(stderr, "%s[cpu][fetch] invalid inst length at pc %#.8x!%s\n", ANSI_RED, cpu->pc, ANSI_RESET);
+            return 0;
+        }
+        return inst >> (64 - *inst_length * 8);
+    }
     *inst_length = getInstLength(cpu);
     if (*inst_length == 0) {
         fprintf(stderr, "%s[cpu][fetch] invalid inst length at pc %#.8x!%s\n", ANSI_RED, cpu->pc, ANSI_RESET);
         return 0;
     }
-    if (cpu->pc + *inst_length > DRAM_SIZE) {
+    if (cpu->pc + *inst_length > cpu->bus.dram.size) {
         fprintf(stderr, "%s[cpu][fetch] pc out of range: %#.8x!%s\n", ANSI_RED, cpu->pc, ANSI_RESET);
         return 0;
     }
     return bus_load(&(cpu->bus), cpu->pc, *inst_length * 8);
 }
 
+/*
+ * prefetch_info_refs
+ * 作用：线性扫描镜像中的 send 与 domain_set，预先物化其引用的 builtin/domain 条目并编译 display 模板。
+ * 行为：按指令长度顺序解码（顺带填充解码缓存），无法解码的字节跳过；未扫到的 ID 在首次执行时按需物化。
+ */
+static void prefetch_info_refs(CPU *cpu, uint64_t image_size) {
+    for (uint64_t pc = DRAM_BASE; pc < DRAM_BASE + image_size; ) {
+        const DecodedInst* d = cpu_decode_at(cpu, pc);
+        if (!d) {
+            pc++;
+            continue;
+        }
+        if (d->op == INST_OP_SEND_DISPLAY || d->op == INST_OP_SEND_EXEC || d->op == INST_OP_SEND_UNKNOWN)
+            prefetch_builtin_info(d->imm);
+        else if (d->op == INST_OP_DOMAIN_SET)
+            prefetch_domain_info((uint8_t)d->imm);
+        pc += d->length;
+    }
+}
+
+/*
+ * cpu_init_caches
+ * 作用：为已加载的程序镜像建立解码缓存与基本块缓存。
+ * 行为：
+ *   - 两者都覆盖 [DRAM_BASE, DRAM_BASE+image_size)，按需懒构建；
+ *   - 解码缓存挂到总线上，bus_store 写入时按行失效，基本块随解码缓存代数失效。
+ */
+void cpu_init_caches(CPU *cpu, uint64_t image_size) {
+    decode_cache_init(&cpu->icache, DRAM_BASE, image_size);
+    block_cache_init(&cpu->bcache, DRAM_BASE, image_size);
+    cpu->bus.icache = &cpu->icache;
+    prefetch_info_refs(cpu, image_size);
+}
+
+/*
+ * cpu_fetch_decoded
+ * 作用：取指并返回预解码记录。
+ * 行为：
+ *   - 命中解码缓存时直接返回，不再访问总线与解析位域；
+ *   - 未命中时走 cpu_fetch 取指并解码，合法指令写回缓存槽位；
+ *   - PC 超出镜像范围时解码到临时记录，不缓存。
+ */
+const DecodedInst* cpu_fetch_decoded(CPU *cpu) {
+    DecodedInst *d = decode_cache_lookup(&cpu->icache, cpu->pc);
+    if (d && d->valid)
+        return d;
+    if (!d)
+        d = &cpu->icache.scratch;
+
+    uint8_t inst_length;
+    uint64_t inst = cpu_fetch(cpu, &inst_length);
+    int ok = cpu_decode(inst, inst_length, d);
+    d->valid = (ok && d != &cpu->icache.scratch && cpu->pc + inst_length <= cpu->bus.dram.size);
+    return d;
+}
+
+/*
+ * cpu_decode_at
+ * 作用：解码镜像内任意 PC 处的指令（构建基本块时向前查看），不改变 cpu->pc。
+ * 行为：
+ *   - 命中解码缓存直接返回；
+ *   - 否则静默判断长度并解码写回缓存；
+ * 返回：合法指令的缓存记录；超出镜像、长度未知或解码失败返回 NULL，不打印日志。
+ */
+const DecodedInst* cpu_decode_at(CPU *cpu, uint64_t pc) {
+    DecodedInst *d = decode_cache_lookup(&cpu->icache, pc);
+    if (!d)
+        return NULL;
+    if (d->valid)
+        return d;
+    if (pc + DECODE_MAX_INST_LEN > cpu->bus.dram.size)
+        return NULL;
+
+    uint64_t inst = dram_fast_load_64(&cpu->bus.dram, pc);
+    uint8_t inst_length = inst_size_of((inst >> 60) & 0xF, inst);
+    if (inst_length == 0)
+        return NULL;
+    if (!cpu_decode(inst >> (64 - inst_length * 8), inst_length, d))
+        return NULL;
+    d->valid = 1;
+    return d;
+}
+
 //=====================================================================================
 // Assess Memory
 //=====================================================================================
@@ -151,91 +270,216 @@ void cpu_store(CPU* cpu, uint64_t addr, uint64_t size, uint64_t value) {
     bus_store(&(cpu->bus), addr, size, value);
 }
 
+/*
+ * cpu_load_signal
+ * 作用：load 指令的取值（解释器、JIT 退出点与 AOT 生成代码共用）。
+ * 行为：
+ *   - 地址映射到总线设备（如 --dbg-csr 的调试 CSR）且不是信号地址时读设备的 32 位寄存器；
+ *   - 否则先将波形激励推进到当前仿真时间（已执行指令数），再按地址查询信号值。
+ * 示例：
+ *   cpu_load_signal(cpu, 0xFFF004) => 该 load 指令的 PC（挂载调试 CSR 时）
+ */
+uint32_t cpu_load_signal(CPU* cpu, uint32_t addr) {
+    const BUS_DEVICE* dev = bus_io_device(&cpu->bus, addr);
+    if (dev && !signal_exists(addr))
+        return (uint32_t)dev->read(dev->ctx, addr - dev->base, 32);
+    if (cpu->stim.enabled)
+        stimulus_advance(&cpu->stim, cpu->inst_retired);
+    return get_signal_value(addr);
+}
+
 //=====================================================================================
-// Instruction Decoder Functions
+//   Instruction Disassembly
 //=====================================================================================
 
+/*
+ * print_disasm
+ * 作用：打印预解码指令的反汇编行。
+ * 行为：
+ *   - 按 op 输出助记符与操作数，两种执行内核共用；
+ *   - send/非法编码等由执行函数自行输出结果或错误，这里不打印；
+ *   - 延迟格式化模式下只记录原始指令（DISASM 事件）。
+ * 示例：
+ *   print_disasm(d) => "jmpc r1 != r0 offset=0x1"
+ */
+static void print_disasm(const DecodedInst* d) {
+    static const char* func_symbols[] = {"==", "!=", ">", "<", ">=", "<="};
+    if (g_log_deferred) {
+        uint32_t a[3] = { (uint32_t)d->raw, (uint32_t)(d->raw >> 32), d->length };
+        log_event(LOG_EV_DISASM, 3, a);
+        return;
+    }
+    switch (d->op) {
+        // 8字节
+        case INST_OP_MOVI:
+            log_printf("%smov r%u, 0x%x%s\n", ANSI_BOLD_BLUE, d->rd, d->imm, ANSI_RESET);
+            break;
+        case INST_OP_TIMER_RESET:
+            log_printf("%stimer_set timer%u reset%s\n", ANSI_BOLD_BLUE, d->rd, ANSI_RESET);
+            break;
+        case INST_OP_TIMER_DISABLE:
+            log_printf("%stimer_set timer%u disable%s\n", ANSI_BOLD_BLUE, d->rd, ANSI_RESET);
+            break;
+        case INST_OP_TIMER_ENABLE:
+            log_printf("%stimer_set timer%u enable%s\n", ANSI_BOLD_BLUE, d->rd, ANSI_RESET);
+            break;
+        case INST_OP_TIMER_CFG_ENABLE:
+            log_printf("%stimer_set timer%u %s threshold=%lu pc_off=%d%s\n", ANSI_BOLD_BLUE, d->rd, "cfg_enable", (uint64_t)d->imm, d->offset, ANSI_RESET);
+            break;
+        // 4字节
+        case INST_OP_JMPC_EQ: case INST_OP_JMPC_NE: case INST_OP_JMPC_GT:
+        case INST_OP_JMPC_LT: case INST_OP_JMPC_GE: case INST_OP_JMPC_LE:
+            log_printf("%sjmpc r%u %s r%u offset=0x%x%s\n", ANSI_BOLD_BLUE, d->rs1, func_symbols[d->func], d->rs2, d->offset, ANSI_RESET);
+            break;
+        case INST_OP_JMPC_POS:
+            log_printf("%sjmpc r%u == 'bP offset=0x%x%s\n", ANSI_BOLD_BLUE, d->rs1, d->offset, ANSI_RESET);
+            break;
+        case INST_OP_JMPC_NEG: case INST_OP_JMPC_UNKNOWN:
+            log_printf("%sjmpc r%u == 'bN offset=0x%x%s\n", ANSI_BOLD_BLUE, d->rs1, d->offset, ANSI_RESET);
+            break;
+        case INST_OP_ARITH_AND:
+            log_printf("%sbit_op r%u = r%u & r%u%s\n", ANSI_BOLD_BLUE, d->rd, d->rs1, d->rs2, ANSI_RESET);
+            break;
+        case INST_OP_ARITH_OR:
+            log_printf("%sbit_op r%u = r%u | r%u%s\n", ANSI_BOLD_BLUE, d->rd, d->rs1, d->rs2, ANSI_RESET);
+            break;
+        case INST_OP_ARITH_XOR:
+            log_printf("%sbit_op r%u = r%u ^ r%u%s\n", ANSI_BOLD_BLUE, d->rd, d->rs1, d->rs2, ANSI_RESET);
+            break;
+        case INST_OP_ARITH_REDU_AND:
+            log_printf("%sredu_and r%u = &r%u%s\n", ANSI_BOLD_BLUE, d->rd, d->rs1, ANSI_RESET);
+            break;
+        case INST_OP_ARITH_REDU_OR:
+            log_printf("%sredu_or r%u = |r%u%s\n", ANSI_BOLD_BLUE, d->rd, d->rs1, ANSI_RESET);
+            break;
+        case INST_OP_ARITH_REDU_XOR:
+            log_printf("%sredu_xor r%u = ^r%u%s\n", ANSI_BOLD_BLUE, d->rd, d->rs1, ANSI_RESET);
+            break;
+        case INST_OP_ARITH_CONCAT:
+            log_printf("%sconcat r%u = {r%u,r%u}%s\n", ANSI_BOLD_BLUE, d->rd, d->rs1, d->rs2, ANSI_RESET);
+            break;
+        case INST_OP_ARITH_ISUNKNOW:
+            log_printf("%sisunknow r%u = isunknow(r%u)%s\n", ANSI_BOLD_BLUE, d->rd, d->rs1, ANSI_RESET);
+            break;
+        case INST_OP_ARITH_ADD:
+            log_printf("%sadd r%u = r%u + r%u%s\n", ANSI_BOLD_BLUE, d->rd, d->rs1, d->rs2, ANSI_RESET);
+            break;
+        case INST_OP_ARITH_SUB:
+            log_printf("%ssub r%u = r%u - r%u%s\n", ANSI_BOLD_BLUE, d->rd, d->rs1, d->rs2, ANSI_RESET);
+            break;
+        case INST_OP_BIT_SLICE:
+            log_printf("%sbit_slice r%u r%u[%u:%u]%s\n", ANSI_BOLD_BLUE, d->rd, d->rs1, d->hi, d->lo, ANSI_RESET);
+            break;
+        case INST_OP_LOAD:
+            log_printf("%sload r%u 0x%x%s\n", ANSI_BOLD_BLUE, d->rd, d->imm, ANSI_RESET);
+            break;
+        // 2字节
+        case INST_OP_TRIGGER_POS:
+            log_printf("%strigger_pos %u%s\n", ANSI_BOLD_BLUE, d->imm, ANSI_RESET);
+            break;
+        case INST_OP_JMP:
+            log_printf("%sjmp %d%s\n", ANSI_BOLD_BLUE, d->offset, ANSI_RESET);
+            break;
+        case INST_OP_MOV:
+            log_printf("%smov r%u, r%u%s\n", ANSI_BOLD_BLUE, d->rd, d->rs1, ANSI_RESET);
+            break;
+        case INST_OP_BL:
+            log_printf("%sbl %d%s\n", ANSI_BOLD_BLUE, d->offset, ANSI_RESET);
+            break;
+        case INST_OP_DOMAIN_SET:
+            log_printf("%sdomain %d%s\n", ANSI_BOLD_BLUE, d->imm, ANSI_RESET);
+            break;
+        case INST_OP_EDGE_P: case INST_OP_EDGE_N: case INST_OP_EDGE_T: case INST_OP_EDGE_L:
+        case INST_OP_EDGE_H: case INST_OP_EDGE_S: case INST_OP_EDGE_X:
+            log_printf("%sedge_detect r%u r%u==%c%s\n", ANSI_BOLD_BLUE, d->rd, d->rs1, "PNTLHSX"[d->func], ANSI_RESET);
+            break;
+        case INST_OP_EDGE_UNKNOWN:
+            log_printf("%sedge_detect r%u==UNK(%u)%s\n", ANSI_BOLD_RED, d->rs1, d->func, ANSI_RESET);
+            break;
+        // 1字节
+        case INST_OP_TRIGGER:
+            log_printf("%strigger%s\n", ANSI_BOLD_BLUE, ANSI_RESET);
+            break;
+        case INST_OP_RET:
+            log_printf("%sret%s\n", ANSI_BOLD_BLUE, ANSI_RESET);
+            break;
+        default:
+            break;
+    }
+}
+
 //=====================================================================================
 //   8BYTE Instruction Execution Functions
 //=====================================================================================
 
 /*
  * exec_MOVI
- * 作用：执行8字节MOVI指令。
- * 行为：
- *   - 根据操作码和立即数将立即数写入目标寄存器；
- *   - 更新CPU状态。
+ * 作用：执行8字节MOVI指令，将立即数写入目标寄存器。
  */
-void exec_MOVI(CPU* cpu, uint64_t inst) {
-    // 8字节MOVI指令（立即数到寄存器）
-    // 格式: [4bit op][1bit func][4bit dest][32bit imm][23bit rsv]
-    // 条件：func[59] = 0
-    uint8_t func_bit = (inst >> 59) & 0x1; // [59]
-    if (func_bit != 0) {
-        fprintf(stderr, "%s[cpu][decode] invalid MOVI func bit!%s\n", ANSI_RED, ANSI_RESET);
-        assert(0);
-    }
+static inline void exec_MOVI(CPU* cpu, const DecodedInst* d) {
+    cpu->regs[d->rd] = d->imm;
+}
 
-    uint8_t dst_reg = (inst >> 55) & 0xF;           // [58-55]
-    uint32_t imm = (inst >> 23) & 0xFFFFFFFF;       // [54-23]
-    printf("%smov r%u, 0x%x%s\n", ANSI_BOLD_BLUE, dst_reg, imm, ANSI_RESET);
-    cpu->regs[dst_reg] = imm;
+// MOVI 编码要求 func[59] = 0
+static inline void exec_MOVI_INVALID(CPU* cpu, const DecodedInst* d) {
+    (void)cpu; (void)d;
+    fprintf(stderr, "%s[cpu][decode] invalid MOVI func bit!%s\n", ANSI_RED, ANSI_RESET);
+    assert(0);
 }
 
 /*
- * exec_TIMER_SET
- * 作用：执行定时器设置指令
+ * exec_TIMER_*
+ * 作用：执行定时器设置指令（reset/disable/enable/cfg_enable）。
  * 行为：
- *   - 根据操作码执行对应的定时器设置操作或配置；
+ *   - reset 清零计数；disable/enable 切换使能；
+ *   - cfg_enable 清零计数、设置阈值与目标PC并使能；
+ *   - 由定时器调度按当前仿真时间更新计数起点与到期时间。
  */
-void exec_TIMER_SET(CPU* cpu, uint64_t inst) {
-    uint8_t id = (inst >> 58) & 0x3;
-    uint8_t func = (inst >> 56) & 0x3;
-    uint64_t threshold = (inst >> 24) & 0xFFFFFFFF;
-    int16_t pc_off = (inst >> 14) & 0x3FF;
-    if (pc_off & 0x200) pc_off = -(1024 - pc_off);
+static inline void exec_TIMER_RESET(CPU* cpu, const DecodedInst* d)   { timer_sched_reset(&cpu->timers, d->rd, cpu->inst_retired); }
+static inline void exec_TIMER_DISABLE(CPU* cpu, const DecodedInst* d) { timer_sched_disable(&cpu->timers, d->rd, cpu->inst_retired); }
+static inline void exec_TIMER_ENABLE(CPU* cpu, const DecodedInst* d)  { timer_sched_enable(&cpu->timers, d->rd, cpu->inst_retired); }
 
-    const char* func_names[] = {"reset", "disable", "enable", "cfg_enable"};
-    const char* fname = func_names[func];
+static inline void exec_TIMER_CFG_ENABLE(CPU* cpu, const DecodedInst* d) {
+    timer_sched_config(&cpu->timers, d->rd, cpu->inst_retired, d->imm, cpu->pc + d->offset);
+}
 
-    if (id >= 2) {
-        fprintf(stderr, "%s[cpu][timer_set] invalid id: %u!%s\n", ANSI_RED, id, ANSI_RESET);
-        return;
-    }
-    if (func == 0) {
-        printf("%stimer_set timer%u reset%s\n", ANSI_BOLD_BLUE, id, ANSI_RESET);
-        cpu->timer[id] = 0;
-    } else if (func == 1) {
-        printf("%stimer_set timer%u disable%s\n", ANSI_BOLD_BLUE, id, ANSI_RESET);
-        cpu->timer_enabled[id] = 0;
-    } else if (func == 2) {
-        printf("%stimer_set timer%u enable%s\n", ANSI_BOLD_BLUE, id, ANSI_RESET);
-        cpu->timer_enabled[id] = 1;
-    } else {
-        printf("%stimer_set timer%u %s threshold=%lu pc_off=%d%s\n", ANSI_BOLD_BLUE, id, fname, threshold, pc_off, ANSI_RESET);
-        cpu->timer[id] = 0;
-        cpu->timer_threshold[id] = threshold;
-        cpu->timer_target_pc[id] = cpu->pc + pc_off;
-        cpu->timer_enabled[id] = 1;
-    }
+static inline void exec_TIMER_INVALID(CPU* cpu, const DecodedInst* d) {
+    (void)cpu;
+    fprintf(stderr, "%s[cpu][timer_set] invalid id: %u!%s\n", ANSI_RED, d->rd, ANSI_RESET);
 }
 
 /*
  * decode_eight_byte_inst
  * 作用：解码8字节指令。
  * 行为：
- *   - 根据操作码执行对应的8字节指令；
+ *   - 根据操作码解析位域并选择对应的处理函数编号；
  *   - 返回1表示成功，返回0表示失败。
  */
-int decode_eight_byte_inst(CPU* cpu, uint64_t inst) {
+int decode_eight_byte_inst(uint64_t inst, DecodedInst* d) {
     uint8_t opcode = (inst >> 60) & 0xF;
+    d->opcode = opcode;
     switch (opcode) {
         case 0x7: // MOVI (8-byte immediate)
-            exec_MOVI(cpu, inst);
+            // 格式: [4bit op][1bit func][4bit dest][32bit imm][23bit rsv]
+            d->func = (inst >> 59) & 0x1;           // [59]
+            d->rd = (inst >> 55) & 0xF;             // [58-55]
+            d->imm = (inst >> 23) & 0xFFFFFFFF;     // [54-23]
+            d->op = d->func == 0 ? INST_OP_MOVI : INST_OP_MOVI_INVALID;
             break;
-        case 0xF: // TIMER_SET
-            exec_TIMER_SET(cpu, inst);
+        case 0xF: { // TIMER_SET
+            // 格式: [4bit op][2bit id][2bit func][32bit threshold][10bit pc_off][14bit rsv]
+            static const uint16_t timer_ops[] = {
+                INST_OP_TIMER_RESET, INST_OP_TIMER_DISABLE, INST_OP_TIMER_ENABLE, INST_OP_TIMER_CFG_ENABLE
+            };
+            int16_t pc_off = (inst >> 14) & 0x3FF;
+            if (pc_off & 0x200) pc_off = -(1024 - pc_off);
+            d->rd = (inst >> 58) & 0x3;
+            d->func = (inst >> 56) & 0x3;
+            d->imm = (inst >> 24) & 0xFFFFFFFF;
+            d->offset = pc_off;
+            d->op = d->rd < CPU_TIMER_COUNT ? timer_ops[d->func] : INST_OP_TIMER_INVALID;
             break;
+        }
         default:
             fprintf(stderr, "%s[cpu][decode] 8-byte opcode:0x%x%s\n", ANSI_RED, opcode, ANSI_RESET);
             return 0;
@@ -248,212 +492,167 @@ int decode_eight_byte_inst(CPU* cpu, uint64_t inst) {
 //=====================================================================================
 
 /*
- * exec_JMPC
- * 作用：执行跳转条件指令。
+ * exec_JMPC_*
+ * 作用：执行条件跳转指令。
  * 行为：
- *   - 根据操作码和源寄存器值执行跳转条件判断；
- *   - 如果条件满足，更新PC寄存器。
+ *   - 比较类（== != > < >= <=）比较两个源寄存器；
+ *   - 边沿类（P/N）比较 src1 当前值与上一周期值的 bit0；
+ *   - 条件满足时 pc += offset（offset 已符号扩展）。
  */
-void exec_JMPC(CPU* cpu, uint32_t inst) {
-    uint32_t func = (inst >> 24) & 0xF;
-    uint32_t src1_reg = (inst >> 20) & 0xF;
-    uint32_t src2_reg = (inst >> 16) & 0xF;
-    int8_t addr = (int8_t)((inst >> 8) & 0xFF);
-    // 处理有符号扩展
-    if (addr & 0x80) addr = -(256 - addr);
+static inline void exec_JMPC_EQ(CPU* cpu, const DecodedInst* d) { if (cpu->regs[d->rs1] == cpu->regs[d->rs2]) cpu->pc += d->offset; }
+static inline void exec_JMPC_NE(CPU* cpu, const DecodedInst* d) { if (cpu->regs[d->rs1] != cpu->regs[d->rs2]) cpu->pc += d->offset; }
+static inline void exec_JMPC_GT(CPU* cpu, const DecodedInst* d) { if (cpu->regs[d->rs1] >  cpu->regs[d->rs2]) cpu->pc += d->offset; }
+static inline void exec_JMPC_LT(CPU* cpu, const DecodedInst* d) { if (cpu->regs[d->rs1] <  cpu->regs[d->rs2]) cpu->pc += d->offset; }
+static inline void exec_JMPC_GE(CPU* cpu, const DecodedInst* d) { if (cpu->regs[d->rs1] >= cpu->regs[d->rs2]) cpu->pc += d->offset; }
+static inline void exec_JMPC_LE(CPU* cpu, const DecodedInst* d) { if (cpu->regs[d->rs1] <= cpu->regs[d->rs2]) cpu->pc += d->offset; }
 
-    // 打印跳转条件指令
-    const char* func_symbols[] = {"==", "!=", ">", "<", ">=", "<="};
-    if (func <= 0x5) {
-        printf("%sjmpc r%u %s r%u offset=0x%x%s\n", ANSI_BOLD_BLUE, src1_reg, func_symbols[func], src2_reg, addr, ANSI_RESET);
-    } else {
-        if (func == 0x6) {
-            printf("%sjmpc r%u == 'bP offset=0x%x%s\n", ANSI_BOLD_BLUE, src1_reg, addr, ANSI_RESET);
-        } else {
-            printf("%sjmpc r%u == 'bN offset=0x%x%s\n", ANSI_BOLD_BLUE, src1_reg, addr, ANSI_RESET);
-        }
-    }
-    
-    // 获取源操作数值
-    uint32_t src1 = cpu->regs[src1_reg];
-    uint32_t src2 = cpu->regs[src2_reg];
-    
-    // 使用查找表优化条件判断
-    bool should_jump = false;
-    
-    // 根据func值确定比较结果
-    switch (func) {
-        case 0x0: should_jump = (src1 == src2); break;
-        case 0x1: should_jump = (src1 != src2); break;
-        case 0x2: should_jump = (src1 > src2); break;
-        case 0x3: should_jump = (src1 < src2); break;
-        case 0x4: should_jump = (src1 >= src2); break;
-        case 0x5: should_jump = (src1 <= src2); break;
-        case 0x6: { // 上升沿
-            uint8_t prev = cpu->prev_regs[src1_reg] & 1;
-            uint8_t curr = cpu->regs[src1_reg] & 1;
-            should_jump = (prev == 0 && curr == 1);
-            break;
-        }
-        case 0x7: { // 下降沿
-            uint8_t prev = cpu->prev_regs[src1_reg] & 1;
-            uint8_t curr = cpu->regs[src1_reg] & 1;
-            should_jump = (prev == 1 && curr == 0);
-            break;
-        }
-        default:
-            fprintf(stderr, "%s[cpu][decode] exec_JMPC error!%s\n", ANSI_RED, ANSI_RESET);
-            assert(0);
-            return;
-    }
-    
-    // 如果条件满足，执行跳转
-    if (should_jump) {
-        cpu->pc += addr;
+// 比较类条件跳转的通用形式：超级指令的第二条指令按 op 选择比较方式
+static inline void exec_JMPC_CMP(CPU* cpu, const DecodedInst* d) {
+    switch (d->op) {
+        case INST_OP_JMPC_EQ: exec_JMPC_EQ(cpu, d); break;
+        case INST_OP_JMPC_NE: exec_JMPC_NE(cpu, d); break;
+        case INST_OP_JMPC_GT: exec_JMPC_GT(cpu, d); break;
+        case INST_OP_JMPC_LT: exec_JMPC_LT(cpu, d); break;
+        case INST_OP_JMPC_GE: exec_JMPC_GE(cpu, d); break;
+        default:              exec_JMPC_LE(cpu, d); break;
     }
 }
 
+static inline void exec_JMPC_POS(CPU* cpu, const DecodedInst* d) { // 上升沿
+    if (signal_store_edge(&cpu->sig, EDGE_CLASS_P, d->rs1)) cpu->pc += d->offset;
+}
+
+static inline void exec_JMPC_NEG(CPU* cpu, const DecodedInst* d) { // 下降沿
+    if (signal_store_edge(&cpu->sig, EDGE_CLASS_N, d->rs1)) cpu->pc += d->offset;
+}
+
+static inline void exec_JMPC_UNKNOWN(CPU* cpu, const DecodedInst* d) {
+    (void)cpu; (void)d;
+    fprintf(stderr, "%s[cpu][decode] exec_JMPC error!%s\n", ANSI_RED, ANSI_RESET);
+    assert(0);
+}
+
 /*
- * exec_ARITH_OP
- * 作用：执行算术操作指令。
- * 行为：
- *   - 根据操作码执行对应的算术操作；
- *   - 更新目标寄存器的值。
+ * exec_ARITH_*
+ * 作用：执行算术/位运算指令，结果写回目标寄存器。
  */
-void exec_ARITH_OP(CPU* cpu, uint32_t inst) {
-    uint8_t func = (inst >> 24) & 0xF;
-    uint8_t dst_reg = (inst >> 20) & 0xF;
-    uint8_t src1_reg = (inst >> 16) & 0xF;
-    uint8_t src2_reg = (inst >> 12) & 0xF;
-    uint32_t src1 = cpu->regs[src1_reg];
-    uint32_t src2 = cpu->regs[src2_reg];
-    switch (func) {
-        case 0x0:
-            printf("%sbit_op r%u = r%u & r%u%s\n", ANSI_BOLD_BLUE, dst_reg, src1_reg, src2_reg, ANSI_RESET);
-            cpu->regs[dst_reg] = src1 & src2;
-            break;
-        case 0x1:
-            printf("%sbit_op r%u = r%u | r%u%s\n", ANSI_BOLD_BLUE, dst_reg, src1_reg, src2_reg, ANSI_RESET);
-            cpu->regs[dst_reg] = src1 | src2;
-            break;
-        case 0x2:
-            printf("%sbit_op r%u = r%u ^ r%u%s\n", ANSI_BOLD_BLUE, dst_reg, src1_reg, src2_reg, ANSI_RESET);
-            cpu->regs[dst_reg] = src1 ^ src2;
-            break;
-        case 0x3: {
-            printf("%sredu_and r%u = &r%u%s\n", ANSI_BOLD_BLUE, dst_reg, src1_reg, ANSI_RESET);
-            uint32_t x = src1;
-            uint32_t r = 1;
-            for (int i = 0; i < 32; i++) r &= ((x >> i) & 1); // 与操作，判断是否所有位都是1
-            cpu->regs[dst_reg] = r;
-            break;
-        }
-        case 0x4: {
-            printf("%sredu_or r%u = |r%u%s\n", ANSI_BOLD_BLUE, dst_reg, src1_reg, ANSI_RESET);
-            uint32_t x = src1;
-            uint32_t r = 0;
-            for (int i = 0; i < 32; i++) r |= ((x >> i) & 1); // 或操作，判断是否有任意位是1
-            cpu->regs[dst_reg] = r;
-            break;
-        }
-        case 0x5: {
-            printf("%sredu_xor r%u = ^r%u%s\n", ANSI_BOLD_BLUE, dst_reg, src1_reg, ANSI_RESET);
-            uint32_t x = src1;
-            uint32_t r = 0;
-            for (int i = 0; i < 32; i++) r ^= ((x >> i) & 1); // 异或操作，判断是否有奇数个1
-            cpu->regs[dst_reg] = r;
-            break;
-        }
-        case 0x6:
-            printf("%sconcat r%u = {r%u,r%u}%s\n", ANSI_BOLD_BLUE, dst_reg, src1_reg, src2_reg, ANSI_RESET);
-            cpu->regs[dst_reg] = ((src1 & 0xFFFF) << 16) | (src2 & 0xFFFF); // 拼接操作，将src1的高16位和src2的低16位拼接起来，暂不考虑溢出
-            break;
-        case 0x7:
-            printf("%sisunknow r%u = isunknow(r%u)%s\n", ANSI_BOLD_BLUE, dst_reg, src1_reg, ANSI_RESET);
-            cpu->regs[dst_reg] = 1; // 暂不考虑isunknow操作，默认返回1
-            break;
-        case 0x8:
-            printf("%sadd r%u = r%u + r%u%s\n", ANSI_BOLD_BLUE, dst_reg, src1_reg, src2_reg, ANSI_RESET);
-            cpu->regs[dst_reg] = src1 + src2;
-            break;
-        case 0x9:
-            printf("%ssub r%u = r%u - r%u%s\n", ANSI_BOLD_BLUE, dst_reg, src1_reg, src2_reg, ANSI_RESET);
-            cpu->regs[dst_reg] = src1 - src2;
-            break;
-        default:
-            fprintf(stderr, "%s[cpu][decode] exec_ARITH_OP error!\n%s", ANSI_RED, ANSI_RESET);
-            assert(0);
-            break;
-    }
+static inline void exec_ARITH_AND(CPU* cpu, const DecodedInst* d) { cpu->regs[d->rd] = cpu->regs[d->rs1] & cpu->regs[d->rs2]; }
+static inline void exec_ARITH_OR(CPU* cpu, const DecodedInst* d)  { cpu->regs[d->rd] = cpu->regs[d->rs1] | cpu->regs[d->rs2]; }
+static inline void exec_ARITH_XOR(CPU* cpu, const DecodedInst* d) { cpu->regs[d->rd] = cpu->regs[d->rs1] ^ cpu->regs[d->rs2]; }
+static inline void exec_ARITH_ADD(CPU* cpu, const DecodedInst* d) { cpu->regs[d->rd] = cpu->regs[d->rs1] + cpu->regs[d->rs2]; }
+static inline void exec_ARITH_SUB(CPU* cpu, const DecodedInst* d) { cpu->regs[d->rd] = cpu->regs[d->rs1] - cpu->regs[d->rs2]; }
+
+// 缩位与：判断是否所有位都是1
+static inline void exec_ARITH_REDU_AND(CPU* cpu, const DecodedInst* d) { cpu->regs[d->rd] = cpu->regs[d->rs1] == 0xFFFFFFFFu; }
+// 缩位或：判断是否有任意位是1
+static inline void exec_ARITH_REDU_OR(CPU* cpu, const DecodedInst* d)  { cpu->regs[d->rd] = cpu->regs[d->rs1] != 0; }
+// 缩位异或：判断是否有奇数个1
+static inline void exec_ARITH_REDU_XOR(CPU* cpu, const DecodedInst* d) { cpu->regs[d->rd] = __builtin_parity(cpu->regs[d->rs1]); }
+
+// 拼接操作，将src1的低16位和src2的低16位拼接起来，暂不考虑溢出
+static inline void exec_ARITH_CONCAT(CPU* cpu, const DecodedInst* d) {
+    cpu->regs[d->rd] = ((cpu->regs[d->rs1] & 0xFFFF) << 16) | (cpu->regs[d->rs2] & 0xFFFF);
+}
+
+// 暂不考虑isunknow操作，默认返回1
+static inline void exec_ARITH_ISUNKNOW(CPU* cpu, const DecodedInst* d) { cpu->regs[d->rd] = 1; }
+
+static inline void exec_ARITH_UNKNOWN(CPU* cpu, const DecodedInst* d) {
+    (void)cpu; (void)d;
+    fprintf(stderr, "%s[cpu][decode] exec_ARITH_OP error!\n%s", ANSI_RED, ANSI_RESET);
+    assert(0);
 }
 
 /*
  * exec_BIT_SLICE
  * 作用：执行位切片操作指令。
  * 行为：
- *   - 根据操作码执行对应的位切片操作；
- *   - 更新目标寄存器的值。
+ *   - 提取 src[end:start] 写入目标寄存器；
+ *   - start > end 视为编码错误。
  */
-void exec_BIT_SLICE(CPU* cpu, uint32_t inst) {
-    uint8_t Dst = (inst >> 24) & 0xF;      // [27-24]
-    uint8_t Src = (inst >> 20) & 0xF;      // [23-20]
-    uint8_t End = (inst >> 15) & 0x1F;   // [19-15]
-    uint8_t Start  = (inst >> 10) & 0x1F;     // [14-10]
-    printf("%sbit_slice r%u r%u[%u:%u]%s\n", ANSI_BOLD_BLUE, Dst, Src, End, Start, ANSI_RESET);
-    // 实际BIT_SLICE操作
-    uint32_t src1 = cpu->regs[Src];    
+static inline void exec_BIT_SLICE(CPU* cpu, const DecodedInst* d) {
     // 确保Start <= End
-    if (Start > End) {
+    if (d->lo > d->hi) {
         fprintf(stderr, "%s[cpu][decode] bit_slice error: Start > End%s\n", ANSI_RED, ANSI_RESET);
         assert(0);
     }
     // 计算掩码: 创建一个长度为(End-Start+1)的全1位掩码
-    uint32_t mask = ((1U << (End - Start + 1)) - 1);
+    uint32_t mask = ((1U << (d->hi - d->lo + 1)) - 1);
     // 右移提取指定位段，然后通过掩码保留需要的位
-    uint32_t res = (src1 >> Start) & mask;
-    // 存储结果到目标寄存器
-    cpu->regs[Dst] = res;
+    cpu->regs[d->rd] = (cpu->regs[d->rs1] >> d->lo) & mask;
 }
 
 /*
  * exec_LOAD
  * 作用：执行加载指令。
  * 行为：
- *   - 根据操作码执行对应的加载操作；
+ *   - 按地址获取信号变量值（拆分汇聚处理后），地址映射到总线设备时读设备寄存器；
  *   - 更新目标寄存器的值。
  */
-void exec_LOAD(CPU* cpu, uint32_t inst) {
-    uint32_t dst = (inst >> 24) & 0xF;
-    uint32_t addr = inst & 0xFFFFFF;
-    printf("%sload r%u 0x%x%s\n", ANSI_BOLD_BLUE, dst, addr, ANSI_RESET);
-    // 实际LOAD操作可在此实现，获取信号变量值（拆分汇聚处理后）
-    uint32_t val = get_signal_value(addr);
-    cpu->regs[dst] = val;
-    printf("%sGet signal var from addr[0x%x] = 0x%x%s\n", ANSI_BOLD_GREEN, addr, val, ANSI_RESET);
+static void print_load(uint32_t addr, uint32_t val) {
+    if (g_log_deferred) {
+        uint32_t a[2] = { addr, val };
+        log_event(LOG_EV_LOAD, 2, a);
+        return;
+    }
+    log_printf("%sGet signal var from addr[0x%x] = 0x%x%s\n", ANSI_BOLD_GREEN, addr, val, ANSI_RESET);
+}
+
+static inline void exec_LOAD(CPU* cpu, const DecodedInst* d) {
+    uint32_t val = cpu_load_signal(cpu, d->imm);
+    cpu->regs[d->rd] = val;
+    if (LOG_ENABLED(LOG_TRACE))
+        print_load(d->imm, val);
 }
 
 /*
  * decode_four_byte_inst
- * 作用：解码并执行4字节指令。
+ * 作用：解码4字节指令。
  * 行为：
- *   - 根据操作码执行对应的4字节指令操作；
- *   - 更新CPU状态。
+ *   - 根据操作码解析位域并选择对应的处理函数编号；
+ *   - 返回1表示成功。
  */
-int decode_four_byte_inst(CPU* cpu, uint64_t inst) {
+int decode_four_byte_inst(uint64_t inst, DecodedInst* d) {
+    static const uint16_t jmpc_ops[] = {
+        INST_OP_JMPC_EQ, INST_OP_JMPC_NE, INST_OP_JMPC_GT, INST_OP_JMPC_LT,
+        INST_OP_JMPC_GE, INST_OP_JMPC_LE, INST_OP_JMPC_POS, INST_OP_JMPC_NEG
+    };
+    static const uint16_t arith_ops[] = {
+        INST_OP_ARITH_AND, INST_OP_ARITH_OR, INST_OP_ARITH_XOR,
+        INST_OP_ARITH_REDU_AND, INST_OP_ARITH_REDU_OR, INST_OP_ARITH_REDU_XOR,
+        INST_OP_ARITH_CONCAT, INST_OP_ARITH_ISUNKNOW, INST_OP_ARITH_ADD, INST_OP_ARITH_SUB
+    };
     uint32_t inst_32 = inst & 0xFFFFFFFF;
     uint8_t opcode = (inst_32 >> 28) & 0xF;
+    d->opcode = opcode;
     switch (opcode) {
-        case 0x0: // JMPC
-            exec_JMPC(cpu, inst_32);
+        case 0x0: { // JMPC
+            int8_t addr = (int8_t)((inst_32 >> 8) & 0xFF);
+            d->func = (inst_32 >> 24) & 0xF;
+            d->rs1 = (inst_32 >> 20) & 0xF;
+            d->rs2 = (inst_32 >> 16) & 0xF;
+            d->offset = addr;
+            d->op = d->func <= 0x7 ? jmpc_ops[d->func] : INST_OP_JMPC_UNKNOWN;
             break;
+        }
         case 0x1: // ARITH_OP
-            exec_ARITH_OP(cpu, inst_32);
+            d->func = (inst_32 >> 24) & 0xF;
+            d->rd = (inst_32 >> 20) & 0xF;
+            d->rs1 = (inst_32 >> 16) & 0xF;
+            d->rs2 = (inst_32 >> 12) & 0xF;
+            d->op = d->func <= 0x9 ? arith_ops[d->func] : INST_OP_ARITH_UNKNOWN;
             break;
         case 0x6: // BIT_SLICE
-            exec_BIT_SLICE(cpu, inst_32);
+            d->rd = (inst_32 >> 24) & 0xF;      // [27-24]
+            d->rs1 = (inst_32 >> 20) & 0xF;     // [23-20]
+            d->hi = (inst_32 >> 15) & 0x1F;     // [19-15] end
+            d->lo = (inst_32 >> 10) & 0x1F;     // [14-10] start
+            d->op = INST_OP_BIT_SLICE;
             break;
         case 0xD: // LOAD
-            exec_LOAD(cpu, inst_32);
+            d->rd = (inst_32 >> 24) & 0xF;
+            d->imm = inst_32 & 0xFFFFFF;
+            d->op = INST_OP_LOAD;
             break;
         default:
             fprintf(stderr, "%s[cpu][decode] 4-byte opcode:0x%x!%s\n", ANSI_RED, opcode, ANSI_RESET);
@@ -469,88 +668,56 @@ int decode_four_byte_inst(CPU* cpu, uint64_t inst) {
 
 /*
  * exec_TRIGGER_POS
- * 作用：执行触发位置指令。
- * 行为：
- *   - 根据操作码执行对应的触发位置操作；
- *   - 更新触发位置。
+ * 作用：执行触发位置指令，设定触发采样范围。
  */
-void exec_TRIGGER_POS(CPU* cpu, uint16_t inst) {
-    // 立即数imm为[11:5]位
-    uint8_t imm = (inst >> 5) & 0x7F;
-    printf("%strigger_pos %u%s\n", ANSI_BOLD_BLUE, imm, ANSI_RESET);
+static inline void exec_TRIGGER_POS(CPU* cpu, const DecodedInst* d) {
     // 实际TRIGGER_POS操作可在此实现
-    printf("%sTrigger sample pos set %u%%!%s\n", ANSI_BOLD_GREEN, imm, ANSI_RESET);
+    cpu->trigger_count++;
+    log_printf("%sTrigger sample pos set %u%%!%s\n", ANSI_BOLD_GREEN, d->imm, ANSI_RESET);
 }
 
 /*
  * exec_JMP
- * 作用：执行基本快跳转指令，无需返回。
- * 行为：
- *   - 根据操作码执行对应的跳转操作；
- *   - 更新PC寄存器。
+ * 作用：执行基本块跳转指令，无需返回。
  */
-void exec_JMP(CPU* cpu, uint16_t inst) {
-    // offset为[11:4]，8位有符号
-    int16_t offset = (inst >> 4) & 0xFF;
-    // 处理有符号扩展
-    if (offset & 0x80) offset = -(256 - offset);
-    printf("%sjmp %d%s\n", ANSI_BOLD_BLUE, offset, ANSI_RESET);
-    // 实际JMP操作可在此实现
-    cpu->pc += offset;
+static inline void exec_JMP(CPU* cpu, const DecodedInst* d) {
+    cpu->pc += d->offset;
 }
 
 /*
  * exec_MOV
- * 作用：执行2字节MOV指令。
- * 行为：
- *   - 根据操作码执行对应的2字节MOV操作；
- *   - 更新目标寄存器的值。
+ * 作用：执行2字节MOV指令（寄存器到寄存器）。
  */
-void exec_MOV(CPU* cpu, uint16_t inst) {
-    // 2字节MOV指令（寄存器到寄存器）
-    // 格式: [4bit op][1bit func][4bit dest][4bit src][3bit rsv]
-    uint8_t dst_reg = (inst >> 7) & 0xF;      // bits [10:7]
-    uint8_t src_reg = (inst >> 3) & 0xF;      // bits [6:3]
-    
-    printf("%smov r%u, r%u%s\n", ANSI_BOLD_BLUE, dst_reg, src_reg, ANSI_RESET);
-    
-    // 执行MOV操作：寄存器到寄存器
-    cpu->regs[dst_reg] = cpu->regs[src_reg];
+static inline void exec_MOV(CPU* cpu, const DecodedInst* d) {
+    cpu->regs[d->rd] = cpu->regs[d->rs1];
 }
 
 /*
  * exec_BL
  * 作用：执行函数跳转指令，需返回。
  * 行为：
- *   - 根据操作码执行对应的跳转操作；
+ *   - 保存返回地址到 ret_reg；
  *   - 更新PC寄存器。
  */
-void exec_BL(CPU* cpu, uint16_t inst) {
-    // offset为[11:2]，10位有符号fmovi
-    int16_t offset = (inst >> 2) & 0x3FF;
-    // 处理有符号扩展
-    if (offset & 0x200) offset = -(1024 - offset);
-    printf("%sbl %d%s\n", ANSI_BOLD_BLUE, offset, ANSI_RESET);
-    // 实际BL操作可在此实现
-    cpu->ret_reg = cpu->pc;  // 保存返回地址到R14
-    cpu->pc += offset;
+static inline void exec_BL(CPU* cpu, const DecodedInst* d) {
+    cpu->ret_reg = cpu->pc;
+    cpu->pc += d->offset;
 }
 
 /*
  * exec_DOMAIN_SET
  * 作用：执行域设置指令。
  * 行为：
- *   - 根据操作码执行对应的域设置操作；
- *   - 更新当前域。
+ *   - 更新当前域；
+ *   - 打印 domain_info.db 中的域说明，未找到视为错误。
  */
-void exec_DOMAIN_SET(CPU* cpu, uint16_t inst) {
-    // offset为[11:4]，8位无符号
-    uint8_t offset = (inst >> 4) & 0xFF;
-    printf("%sdomain %d%s\n", ANSI_BOLD_BLUE, offset, ANSI_RESET);
+static inline void exec_DOMAIN_SET(CPU* cpu, const DecodedInst* d) {
+    uint8_t offset = d->imm;
     cpu->domain = offset;
     char* info = get_domain_info(offset);
     if (info) {
-        printf("%sdomain(%s)%s\n", ANSI_BOLD_GREEN, info, ANSI_RESET);
+        if (LOG_ENABLED(LOG_SUMMARY))
+            log_printf("%sdomain(%s)%s\n", ANSI_BOLD_GREEN, info, ANSI_RESET);
     } else {
         fprintf(stderr, "%s[cpu][db] domain not found: %u!%s\n", ANSI_RED, offset, ANSI_RESET);
         assert(0);
@@ -561,107 +728,116 @@ void exec_DOMAIN_SET(CPU* cpu, uint16_t inst) {
  * exec_SEND
  * 作用：执行统一发送指令。
  * 行为：
- *   - 根据操作码执行对应的内建操作（display、exec）；
+ *   - 按 db_id 查询 builtin 信息表并打印内建操作（display 按预编译模板代入当前信号值，exec 原样）；
+ *   - 未知 func 打印错误。
  */
-void exec_SEND(CPU* cpu, uint16_t inst) {
-    uint8_t func = (inst >> 8) & 0xF;
-    uint8_t db_id = (inst >> 1) & 0x7F;
-    // uint8_t extra = inst & 0x1; // 预留
+static inline void send_print(CPU* cpu, const DecodedInst* d) {
+    cpu->send_count++;
+    size_t n;
+    const char* line = builtin_send_line(d->imm, d->func, &n);
+    log_write(line, n);
+}
 
-    char* type = get_builtin_type(db_id);
-    char* content = get_builtin_info(db_id);
+static inline void exec_SEND_DISPLAY(CPU* cpu, const DecodedInst* d) { send_print(cpu, d); }
+static inline void exec_SEND_EXEC(CPU* cpu, const DecodedInst* d)    { send_print(cpu, d); }
 
-    if (type) {
-        printf("%s%s %u: %s%s\n", ANSI_BOLD_BLUE, type, db_id, content ? content : "", ANSI_RESET);
-    } else {
-        printf("%ssend func:0x%x db_id:%u (no builtin info)%s\n", ANSI_BOLD_BLUE, func, db_id, ANSI_RESET);
-    }
-
-    // 根据 func 进行额外的具体发起动作（如有需要）
-    switch (func) {
-        case 0x0: // display
-            break;
-        case 0x1: // exec
-            break;
-        default:
-            fprintf(stderr, "%s[cpu][send] unknown func: 0x%x%s\n", ANSI_RED, func, ANSI_RESET);
-            break;
-    }
+static inline void exec_SEND_UNKNOWN(CPU* cpu, const DecodedInst* d) {
+    send_print(cpu, d);
+    fprintf(stderr, "%s[cpu][send] unknown func: 0x%x%s\n", ANSI_RED, d->func, ANSI_RESET);
 }
 
 /*
- * exec_EDGE_DETECT
- * 作用：执行边缘检测指令。
+ * exec_EDGE_*
+ * 作用：执行边缘检测指令，结果（0/1）写回目标寄存器。
  * 行为：
- *   - 根据操作码执行对应的边缘检测操作；
- *   - 更新目标寄存器的值。
+ *   - 比较 src 的 bit0 在本FCLK周期与前一个FCLK周期的采样值，查采样信号存储中按周期整块计算的边沿类别；
+ *   - 注意这里不是TSL软核的时钟周期而是EMU的时钟周期的信号状态（语义上每条指令开始执行时采样一次，
+ *     线程化内核只在边沿类指令及其前一条指令前实际采样，见 block_build）。
  */
-void exec_EDGE_DETECT(CPU* cpu, uint16_t inst) {
-    uint8_t dst = (inst >> 8) & 0xF;
-    uint8_t src = (inst >> 4) & 0xF;
-    uint8_t func = (inst >> 1) & 0x7;
-    uint8_t curr = cpu->regs[src] & 0x1;
-    uint8_t prev = cpu->prev_regs[src] & 0x1; // 前一个FCLK周期，注意这里不是TSL软核的时钟周期而是EMU的时钟周期的信号状态
-    uint32_t res = 0;
-    if (func == 0) { // 正沿（上升沿，信号从0变为1）
-        printf("%sedge_detect r%u r%u==P%s\n", ANSI_BOLD_BLUE, dst, src, ANSI_RESET);
-        res = (prev == 0 && curr == 1) ? 1 : 0;
-    } else if (func == 1) { // 负沿（下降沿，信号从1变为0）
-        printf("%sedge_detect r%u r%u==N%s\n", ANSI_BOLD_BLUE, dst, src, ANSI_RESET);
-        res = (prev == 1 && curr == 0) ? 1 : 0;
-    } else if (func == 2) { // 任意跳变（正沿或负沿，即信号状态发生变化）
-        printf("%sedge_detect r%u r%u==T%s\n", ANSI_BOLD_BLUE, dst, src, ANSI_RESET);
-        res = (prev != curr) ? 1 : 0;
-    } else if (func == 3) { // 稳定低电平（连续2个FCLK周期保持0）
-        printf("%sedge_detect r%u r%u==L%s\n", ANSI_BOLD_BLUE, dst, src, ANSI_RESET);
-        res = (prev == 0 && curr == 0) ? 1 : 0;
-    } else if (func == 4) { // 稳定高电平（连续2个FCLK周期保持1）
-        printf("%sedge_detect r%u r%u==H%s\n", ANSI_BOLD_BLUE, dst, src, ANSI_RESET);
-        res = (prev == 1 && curr == 1) ? 1 : 0;
-    } else if (func == 5) { // 稳定状态（连续2个FCLK周期保持低或高，即无跳变）
-        printf("%sedge_detect r%u r%u==S%s\n", ANSI_BOLD_BLUE, dst, src, ANSI_RESET);
-        res = (prev == curr) ? 1 : 0;
-    } else if (func == 6) { // 不关心（任何值都视为匹配）
-        printf("%sedge_detect r%u r%u==X%s\n", ANSI_BOLD_BLUE, dst, src, ANSI_RESET);
-        res = 1;
-    } else {
-        printf("%sedge_detect r%u==UNK(%u)%s\n", ANSI_BOLD_RED, src, func, ANSI_RESET);
-        assert(0);
-    }
-    cpu->regs[dst] = res;
+#define EDGE_CLASS_OF(cpu, d, c) signal_store_edge(&(cpu)->sig, (c), (d)->rs1)
+// 正沿（上升沿，信号从0变为1）
+static inline void exec_EDGE_P(CPU* cpu, const DecodedInst* d) { cpu->regs[d->rd] = EDGE_CLASS_OF(cpu, d, EDGE_CLASS_P); }
+// 负沿（下降沿，信号从1变为0）
+static inline void exec_EDGE_N(CPU* cpu, const DecodedInst* d) { cpu->regs[d->rd] = EDGE_CLASS_OF(cpu, d, EDGE_CLASS_N); }
+// 任意跳变（正沿或负沿，即信号状态发生变化）
+static inline void exec_EDGE_T(CPU* cpu, const DecodedInst* d) { cpu->regs[d->rd] = EDGE_CLASS_OF(cpu, d, EDGE_CLASS_T); }
+// 稳定低电平（连续2个FCLK周期保持0）
+static inline void exec_EDGE_L(CPU* cpu, const DecodedInst* d) { cpu->regs[d->rd] = EDGE_CLASS_OF(cpu, d, EDGE_CLASS_L); }
+// 稳定高电平（连续2个FCLK周期保持1）
+static inline void exec_EDGE_H(CPU* cpu, const DecodedInst* d) { cpu->regs[d->rd] = EDGE_CLASS_OF(cpu, d, EDGE_CLASS_H); }
+// 稳定状态（连续2个FCLK周期保持低或高，即无跳变）
+static inline void exec_EDGE_S(CPU* cpu, const DecodedInst* d) { cpu->regs[d->rd] = EDGE_CLASS_OF(cpu, d, EDGE_CLASS_S); }
+// 不关心（任何值都视为匹配）
+static inline void exec_EDGE_X(CPU* cpu, const DecodedInst* d) { cpu->regs[d->rd] = 1; }
+
+// 边沿类的通用形式（P..X）：op 与边沿类别顺序一致，供超级指令使用
+static inline void exec_EDGE(CPU* cpu, const DecodedInst* d) {
+    cpu->regs[d->rd] = d->op == INST_OP_EDGE_X ? 1 : EDGE_CLASS_OF(cpu, d, (EDGE_CLASS)(d->op - INST_OP_EDGE_P));
+}
+
+static inline void exec_EDGE_UNKNOWN(CPU* cpu, const DecodedInst* d) {
+    assert(0);
+    cpu->regs[d->rd] = 0;
 }
 
 /*
  * decode_two_byte_inst
- * 作用：解码并执行2字节指令。
+ * 作用：解码2字节指令。
  * 行为：
- *   - 根据操作码执行对应的2字节指令操作；
- *   - 更新CPU状态。
+ *   - 根据操作码解析位域并选择对应的处理函数编号；
+ *   - 返回1表示成功，返回0表示失败。
  */
-int decode_two_byte_inst(CPU* cpu, uint64_t inst) {
+int decode_two_byte_inst(uint64_t inst, DecodedInst* d) {
+    static const uint16_t edge_ops[] = {
+        INST_OP_EDGE_P, INST_OP_EDGE_N, INST_OP_EDGE_T, INST_OP_EDGE_L,
+        INST_OP_EDGE_H, INST_OP_EDGE_S, INST_OP_EDGE_X, INST_OP_EDGE_UNKNOWN
+    };
     uint16_t inst_16 = inst & 0xFFFF;
     uint8_t opcode = (inst_16 >> 12) & 0xF;
+    d->opcode = opcode;
     switch (opcode) {
         case 0x4: // TRIGGER_POS
-            exec_TRIGGER_POS(cpu, inst_16);
+            d->imm = (inst_16 >> 5) & 0x7F;     // [11:5]
+            d->op = INST_OP_TRIGGER_POS;
             break;
-        case 0x5: // JMP
-            exec_JMP(cpu, inst_16);
+        case 0x5: { // JMP
+            // offset为[11:4]，8位有符号
+            int16_t offset = (inst_16 >> 4) & 0xFF;
+            if (offset & 0x80) offset = -(256 - offset);
+            d->offset = offset;
+            d->op = INST_OP_JMP;
             break;
+        }
         case 0x7: // MOV (2-byte, register to register)
-            exec_MOV(cpu, inst_16);
+            // 格式: [4bit op][1bit func][4bit dest][4bit src][3bit rsv]
+            d->func = (inst_16 >> 11) & 0x1;
+            d->rd = (inst_16 >> 7) & 0xF;       // bits [10:7]
+            d->rs1 = (inst_16 >> 3) & 0xF;      // bits [6:3]
+            d->op = INST_OP_MOV;
             break;
-        case 0x9: // BL
-            exec_BL(cpu, inst_16);
+        case 0x9: { // BL
+            // offset为[11:2]，10位有符号
+            int16_t offset = (inst_16 >> 2) & 0x3FF;
+            if (offset & 0x200) offset = -(1024 - offset);
+            d->offset = offset;
+            d->op = INST_OP_BL;
             break;
+        }
         case 0xA: // DOMAIN_SET
-            exec_DOMAIN_SET(cpu, inst_16);
+            d->imm = (inst_16 >> 4) & 0xFF;     // [11:4]，8位无符号
+            d->op = INST_OP_DOMAIN_SET;
             break;
         case 0xB: // SEND
-            exec_SEND(cpu, inst_16);
+            d->func = (inst_16 >> 8) & 0xF;
+            d->imm = (inst_16 >> 1) & 0x7F;     // db_id，extra 位 [0] 预留
+            d->op = d->func == 0x0 ? INST_OP_SEND_DISPLAY :
+                    d->func == 0x1 ? INST_OP_SEND_EXEC : INST_OP_SEND_UNKNOWN;
             break;
         case 0xE: // EDGE_DETECT
-            exec_EDGE_DETECT(cpu, inst_16);
+            d->rd = (inst_16 >> 8) & 0xF;
+            d->rs1 = (inst_16 >> 4) & 0xF;
+            d->func = (inst_16 >> 1) & 0x7;
+            d->op = edge_ops[d->func];
             break;
         default:
             fprintf(stderr, "%s[cpu][decode] 2-byte opcode:0x%x!%s\n", ANSI_RED, opcode, ANSI_RESET);
@@ -676,47 +852,47 @@ int decode_two_byte_inst(CPU* cpu, uint64_t inst) {
 
 /*
  * exec_TRIGGER
- * 作用：执行触发指令。
- * 行为：
- *   - 根据操作码执行对应的触发操作；
- *   - 打印触发信号样本信息。
+ * 作用：执行触发指令，打印触发信号样本信息。
  */
-void exec_TRIGGER(CPU* cpu, uint8_t inst) {
-    printf("%strigger%s\n", ANSI_BOLD_BLUE, ANSI_RESET);
+static inline void exec_TRIGGER(CPU* cpu, const DecodedInst* d) {
+    (void)d;
     // 实际TRIGGER操作可在此实现
-    printf("%sTime stop! Start trigger signal sample!%s\n", ANSI_BOLD_GREEN, ANSI_RESET);
+    cpu->trigger_count++;
+    log_printf("%sTime stop! Start trigger signal sample!%s\n", ANSI_BOLD_GREEN, ANSI_RESET);
 }
 
 /*
  * exec_RET
- * 作用：执行返回指令。
- * 行为：
- *   - 根据操作码执行对应的返回操作；
- *   - 更新PC寄存器。
+ * 作用：执行返回指令，PC 恢复为返回地址寄存器。
  */
-void exec_RET(CPU* cpu, uint8_t inst) {
-    printf("%sret%s\n", ANSI_BOLD_BLUE, ANSI_RESET);
-    // 实际RET操作可在此实现
+static inline void exec_RET(CPU* cpu, const DecodedInst* d) {
+    (void)d;
     cpu->pc = cpu->ret_reg;
     cpu->ret_reg = 0;
 }
 
+// 解码失败：不执行任何操作
+static inline void exec_INVALID(CPU* cpu, const DecodedInst* d) {
+    (void)cpu; (void)d;
+}
+
 /*
  * decode_one_byte_inst
- * 作用：解码并执行1字节指令。
+ * 作用：解码1字节指令。
  * 行为：
- *   - 根据操作码执行对应的1字节指令操作；
- *   - 更新CPU状态。
+ *   - 根据操作码选择对应的处理函数编号；
+ *   - 返回1表示成功，返回0表示失败。
  */
-int decode_one_byte_inst(CPU* cpu, uint64_t inst) {
+int decode_one_byte_inst(uint64_t inst, DecodedInst* d) {
     uint8_t inst_8 = inst & 0xFF;
     uint8_t opcode = (inst_8 >> 4) & 0xF;
+    d->opcode = opcode;
     switch (opcode) {
         case 0x03: // trigger
-            exec_TRIGGER(cpu, inst_8);
+            d->op = INST_OP_TRIGGER;
             break;
         case 0x08: // ret
-            exec_RET(cpu, inst_8);
+            d->op = INST_OP_RET;
             break;
         default: {
             fprintf(stderr, "%s[cpu][decode] 1-byte opcode:0x%x!%s\n", ANSI_RED, opcode, ANSI_RESET);
@@ -726,18 +902,19 @@ int decode_one_byte_inst(CPU* cpu, uint64_t inst) {
     return 1;
 }
 
+// op -> 执行函数
+#define TSL_EXEC_ENTRY(name) exec_##name,
+static const exec_fn exec_table[INST_OP_COUNT] = {
+    TSL_INST_OPS(TSL_EXEC_ENTRY)
+};
+#undef TSL_EXEC_ENTRY
+
 //=====================================================================================
 //   Dump Register Info
 //=====================================================================================
 
-/*
- * dump_registers
- * 作用：打印CPU寄存器状态。
- * 行为：
- *   - 打印16个寄存器状态；
- *   - 打印PC寄存器状态。
- */
-void dump_registers(CPU *cpu) {
+// 寄存器转储的文本格式（dump_registers 与延迟格式化的 REGS 事件共用）
+static void print_registers(const uint32_t *regs, uint32_t ret_reg, uint64_t t0, uint64_t t1, uint32_t pc) {
     char* abi[] = { // Application Binary Interface registers
         "R0", "R1",  "R2",  "R3",
         "R4", "R5",  "R6",  "R7",
@@ -748,66 +925,499 @@ void dump_registers(CPU *cpu) {
     int N = 14;
     for (int i = 0; i < N; i++) {
         print_color(ANSI_BOLD);
-        printf("   %4s: %#-13.2x  ", abi[i], cpu->regs[i]);
+        log_printf("   %4s: %#-13.2x  ", abi[i], regs[i]);
         if (i % 4 == 3)
-            printf("\n");
-    }
-    printf("   %4s: %#-13.2x  \n", "RET", cpu->ret_reg);
-    printf("   %4s: %#-13.2x  ", "C0", cpu->regs[14]);
-    printf("   %4s: %#-13.2x  ", "C1", cpu->regs[15]);
-    printf("   %4s: %#-13.2lx  ", "T0", cpu->timer[0]);
-    printf("   %4s: %#-13.2lx  ", "T1", cpu->timer[1]);
-    printf("   %4s: %#-13.2x  ", "PC", cpu->pc);
+            log_printf("\n");
+    }
+    log_printf("   %4s: %#-13.2x  \n", "RET", ret_reg);
+    log_printf("   %4s: %#-13.2x  ", "C0", regs[14]);
+    log_printf("   %4s: %#-13.2x  ", "C1", regs[15]);
+    log_printf("   %4s: %#-13.2lx  ", "T0", t0);
+    log_printf("   %4s: %#-13.2lx  ", "T1", t1);
+    log_printf("   %4s: %#-13.2x  ", "PC", pc);
     print_color(ANSI_RESET);
 }
 
-//=====================================================================================
-//   Cpu Execution root function
-//=====================================================================================
+// 增量寄存器打印：格式与完整转储的单元格相同，每行最多 4 个
+static void dump_register_changes(CPU *cpu) {
+    uint64_t cur[REG_SIG_COUNT];
+    uint32_t changed = reg_delta_sample(&cpu->dump_delta, cpu, cur) & ~(1u << REG_SIG_DOMAIN);
+    int n = 0;
+    print_color(ANSI_BOLD);
+    for (; changed; changed &= changed - 1) {
+        int i = __builtin_ctz(changed);
+        if (n && n % 4 == 0)
+            log_printf("\n");
+        if (reg_signal_widths[i] > 32)
+            log_printf("   %4s: %#-13.2lx  ", reg_signal_names[i], cur[i]);
+        else
+            log_printf("   %4s: %#-13.2x  ", reg_signal_names[i], (uint32_t)cur[i]);
+        n++;
+    }
+    print_color(ANSI_RESET);
+}
 
 /*
- * cpu_execute
- * 作用：执行CPU指令。
+ * dump_registers
+ * 作用：打印CPU寄存器状态。
  * 行为：
- *   - 根据指令长度解码并执行指令；
- *   - 更新CPU状态。
+ *   - 打印16个寄存器状态；
+ *   - 打印PC寄存器状态；
+ *   - 增量模式（--reg-dump=changes）下只打印与上次相比变化的寄存器，首次打印全部；
+ *   - 延迟格式化模式下只记录 REGS 事件。
+ * 示例（增量模式）：
+ *   add r1 = r1 + r2 之后 => "     R1: 0x03                PC: 0x10"
  */
-int cpu_execute(CPU *cpu, uint64_t inst, uint8_t inst_length) {
-    // 打印当前指令地址
-    print_color(ANSI_YELLOW);
-    printf("\n%#.8x -> ", cpu->pc);
+void dump_registers(CPU *cpu) {
+    if (cpu->dump_changes) {
+        dump_register_changes(cpu);
+        return;
+    }
+    uint64_t t0 = timer_sched_value(&cpu->timers, 0, cpu->inst_retired);
+    uint64_t t1 = timer_sched_value(&cpu->timers, 1, cpu->inst_retired);
+    if (g_log_deferred) {
+        uint32_t a[22];
+        memcpy(a, cpu->regs, sizeof(cpu->regs));
+        a[16] = cpu->ret_reg;
+        a[17] = (uint32_t)t0;
+        a[18] = (uint32_t)(t0 >> 32);
+        a[19] = (uint32_t)t1;
+        a[20] = (uint32_t)(t1 >> 32);
+        a[21] = cpu->pc;
+        log_event(LOG_EV_REGS, 22, a);
+        return;
+    }
+    print_registers(cpu->regs, cpu->ret_reg, t0, t1, cpu->pc);
+}
+
+/*
+ * cpu_print_summary
+ * 作用：打印运行结束汇总（quiet/summary/trace 级别）。
+ * 行为：
+ *   - 输出已执行指令数（含空转跳过的指令）、send/trigger 次数与耗时；
+ *   - 有空转跳过时另输出跳过的指令数（skipped），速率只按逐条执行的指令数计算；
+ *   - 输出最终寄存器状态。
+ * 示例：
+ *   cpu_print_summary(cpu, 0.5) => "[SUMMARY]: insts:1200 send:100 trigger:0 time:0.500s ..."
+ *   跳过 4000000000 条时 => "insts:4000001200 skipped:4000000000 send:100 ... (0.00 Minst/s)"
+ */
+void cpu_print_summary(CPU *cpu, double seconds) {
+    uint64_t executed = cpu->inst_retired - cpu->inst_skipped;
+    print_color(ANSI_BOLD);
+    log_printf("\n[SUMMARY]:\n");
+    print_color(ANSI_RESET);
+    print_color(ANSI_BOLD_WHITE);
+    log_printf("   insts:%" PRIu64, cpu->inst_retired);
+    if (cpu->inst_skipped)
+        log_printf(" skipped:%" PRIu64, cpu->inst_skipped);
+    log_printf(" send:%" PRIu64 " trigger:%" PRIu64 " time:%.3fs (%.2f Minst/s)\n",
+           cpu->send_count, cpu->trigger_count, seconds,
+           seconds > 0 ? executed / seconds / 1e6 : 0.0);
     print_color(ANSI_RESET);
+    dump_registers(cpu);
+    log_printf("\n");
+}
 
-    for (int i = 0; i < 14; i++) cpu->prev_regs[i] = 1; // 前一个FCLK周期，注意这里不是TSL软核的时钟周期而是EMU的时钟周期的信号状态，这里赋值模拟
+//=====================================================================================
+//   Cpu Execution root function
+//=====================================================================================
 
-    cpu->pc += inst_length; // update pc for next cpu cycle
+/*
+ * cpu_decode
+ * 作用：将取到的指令解码为预解码记录。
+ * 行为：
+ *   - 清空记录并保存原始指令与长度；
+ *   - 根据指令长度分派到 decode_*_byte_inst 解析位域、选择处理函数编号与执行函数；
+ *   - 返回1表示成功，返回0表示长度非法或操作码未知（此时 op 为 INST_OP_INVALID，长度非法时 length 记为 0，
+ *     执行时由 cpu_execute_decoded 报错，逐条执行的路径不再检查长度）。
+ */
+int cpu_decode(uint64_t inst, uint8_t inst_length, DecodedInst *d) {
+    int ok = 0;
+    memset(d, 0, sizeof(*d));
+    d->raw = inst;
+    d->length = (inst_length == 1 || inst_length == 2 || inst_length == 4 || inst_length == 8) ? inst_length : 0;
 
     if (inst_length == 1) {
-        decode_one_byte_inst(cpu, inst);
+        ok = decode_one_byte_inst(inst, d);
     } else if (inst_length == 2) {
-        decode_two_byte_inst(cpu, inst);
+        ok = decode_two_byte_inst(inst, d);
     } else if (inst_length == 4) {
-        decode_four_byte_inst(cpu, inst);
+        ok = decode_four_byte_inst(inst, d);
     } else if (inst_length == 8) {
-        decode_eight_byte_inst(cpu, inst);
-    } else {
-        fprintf(stderr, "%s[-] ERROR-> inst_length:0x%x!%s\n", ANSI_RED, inst_length, ANSI_RESET);
+        ok = decode_eight_byte_inst(inst, d);
+    }
+    if (!ok)
+        d->op = INST_OP_INVALID;
+    d->exec = exec_table[d->op];
+    return ok;
+}
+
+static void print_inst_addr(uint32_t pc) {
+    if (g_log_deferred) {
+        log_event(LOG_EV_ADDR, 1, &pc);
+        return;
+    }
+    print_color(ANSI_YELLOW);
+    log_printf("\n%#.8x -> ", pc);
+    print_color(ANSI_RESET);
+}
+
+/*
+ * sample_cycle
+ * 作用：仿真时间前进到 now（FCLK 周期边界）时采样信号存储，本周期的采样成为下一周期的“前一个FCLK周期”值。
+ * 行为：先交换信号存储的两组采样并采样寄存器列，再把波形激励推进到 now，订阅信号的变化写入信号索引；
+ *       同一时间重复调用时信号存储不变。
+ */
+static inline void sample_cycle(CPU *cpu, uint64_t now) {
+    signal_store_cycle(&cpu->sig, cpu->regs, now);
+    if (cpu->stim.enabled)
+        stimulus_advance(&cpu->stim, now);
+}
+
+/*
+ * cpu_sample_cycle
+ * 作用：sample_cycle 的外部入口（仿真时间为已执行指令数 + ahead）。JIT 代码在
+ *       波形激励到期、不能在本机代码内完成采样时调用；AOT 生成代码在须采样的指令开始时调用。
+ */
+void cpu_sample_cycle(CPU *cpu, uint32_t ahead) {
+    sample_cycle(cpu, cpu->inst_retired + ahead);
+}
+
+/*
+ * cpu_print_inst
+ * 作用：打印指令地址与反汇编（trace 级别的逐条输出），供轨迹解码工具复用。
+ */
+void cpu_print_inst(const DecodedInst *d, uint32_t pc) {
+    print_inst_addr(pc);
+    print_disasm(d);
+}
+
+/*
+ * cpu_render_event
+ * 作用：按延迟格式化事件的原始参数输出文本，与运行时直接打印的内容一致（tools/tsl_logfmt 使用）。
+ * 返回：已知事件返回1，未知事件返回0。
+ */
+int cpu_render_event(uint16_t ev, const uint32_t *a) {
+    switch (ev) {
+        case LOG_EV_ADDR:
+            print_inst_addr(a[0]);
+            return 1;
+        case LOG_EV_DISASM: {
+            DecodedInst d;
+            cpu_decode(((uint64_t)a[1] << 32) | a[0], (uint8_t)a[2], &d);
+            print_disasm(&d);
+            return 1;
+        }
+        case LOG_EV_LOAD:
+            print_load(a[0], a[1]);
+            return 1;
+        case LOG_EV_REGS:
+            print_registers(a, a[16], ((uint64_t)a[18] << 32) | a[17], ((uint64_t)a[20] << 32) | a[19], a[21]);
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+// 是否逐条采样已执行指令（二进制轨迹或 VCD 波形）
+static inline int cpu_observing(const CPU *cpu) {
+    return cpu->trace.enabled || cpu->vcd.enabled;
+}
+
+/*
+ * cpu_observe_retired
+ * 作用：指令退休（执行与定时器 tick 之后）时写轨迹记录与波形变化，取代逐条的文本打印。
+ */
+static inline void cpu_observe_retired(CPU *cpu, const DecodedInst *d, uint32_t pc) {
+    if (cpu->trace.enabled)
+        trace_record(&cpu->trace, cpu, d, pc);
+    if (cpu->vcd.enabled)
+        vcd_sample(&cpu->vcd, cpu);
+}
+
+/*
+ * cpu_begin_inst
+ * 作用：指令执行前的公共步骤（两种执行内核共用，指令长度已在解码时检查）。
+ * 行为：
+ *   - trace 及以上级别打印当前指令地址与反汇编（level 为常量时判断在编译期消除）；
+ *   - 更新PC到下一条指令，计入已执行指令数；
+ *   - sample 非 0 时进入新的 FCLK 周期（采样信号存储）：线程化内核只在基本块标记的指令
+ *     （读信号或边沿的指令及其前一条）前采样，单步执行时每条都采样。
+ */
+CPU_HOT_INLINE void cpu_begin_inst(CPU *cpu, const DecodedInst *d, LOG_LEVEL level, int sample) {
+    if (level >= LOG_TRACE) {
+        print_inst_addr(cpu->pc);
+        print_disasm(d);
+    }
+    cpu->pc += d->length; // update pc for next cpu cycle
+    cpu->inst_retired++;
+    if (sample)
+        sample_cycle(cpu, cpu->inst_retired);
+}
+
+/*
+ * cpu_execute_decoded
+ * 作用：执行一条预解码指令。
+ * 行为：
+ *   - 打印当前指令地址与反汇编，更新PC到下一条指令；
+ *   - 调用记录中的执行函数；
+ *   - 有定时器到期时跳转；
+ *   - 返回1表示正常，返回0表示指令长度非法（解码时记为 0）。
+ */
+int cpu_execute_decoded(CPU *cpu, const DecodedInst *d) {
+    if (d->length == 0) {
+        if (LOG_ENABLED(LOG_TRACE))
+            print_inst_addr(cpu->pc);
+        fprintf(stderr, "%s[-] ERROR-> inst_length:0x%x!%s\n", ANSI_RED, d->length, ANSI_RESET);
         return 0;
     }
+    cpu_begin_inst(cpu, d, g_log_level, 1);
 
-    // 执行定时器 tick 并跳转，它应该是累加DUT时钟周期，那不应该放在这，暂定
-    timer_tick_and_jump(cpu);
+    d->exec(cpu, d);
+
+    // 定时器到期时跳转，它应该是累加DUT时钟周期，那不应该放在这，暂定
+    if (timer_sched_due(&cpu->timers, cpu->inst_retired))
+        timer_tick_and_jump(cpu);
 
     return 1;  // 明确返回执行状态（1表示正常，0表示异常）
 }
 
+/*
+ * cpu_trace_retired
+ * 作用：JIT 代码每执行完一条指令后回调，输出与解释器逐条执行相同的内容。
+ * 行为：
+ *   - 计入已执行指令数（定时器计数随之推进）；
+ *   - 记录轨迹或波形时交给 cpu_observe_retired，否则打印指令地址与反汇编
+ *     （JIT 覆盖的指令执行时本身无输出，先后顺序不影响结果），full 级别打印寄存器；
+ *   - 仅在 trace 及以上级别或记录轨迹/波形时编译进 JIT 代码。
+ */
+void cpu_trace_retired(CPU *cpu, const DecodedInst *d, uint32_t pc) {
+    cpu->inst_retired++;
+    if (cpu_observing(cpu)) {
+        cpu_observe_retired(cpu, d, pc);
+        return;
+    }
+    cpu_print_inst(d, pc);
+    if (LOG_ENABLED(LOG_FULL))
+        dump_registers(cpu);
+}
+
+/*
+ * cpu_enable_jit
+ * 作用：打开热点基本块的 JIT 编译（--jit）。
+ * 行为：JIT 挂在线程化内核的基本块调度上，switch 内核或宿主不支持时给出提示并继续解释执行。
+ * 返回：打开成功返回1，否则返回0。
+ */
+int cpu_enable_jit(CPU *cpu) {
+#if defined(TSL_THREADED_CORE) && defined(__GNUC__)
+    if (!jit_init(&cpu->jit))
+        return 0;
+    if (cpu_observing(cpu))
+        cpu->jit.trace = 1;
+    return 1;
+#else
+    (void)cpu;
+    fprintf(stderr, "%s[cpu][jit] requires CORE=threaded, using interpreter%s\n", ANSI_YELLOW, ANSI_RESET);
+    return 0;
+#endif
+}
+
+/*
+ * cpu_execute
+ * 作用：执行CPU指令（未缓存路径）。
+ * 行为：
+ *   - 解码到临时记录后调用 cpu_execute_decoded；
+ *   - 更新CPU状态。
+ */
+int cpu_execute(CPU *cpu, uint64_t inst, uint8_t inst_length) {
+    DecodedInst d;
+    cpu_decode(inst, inst_length, &d);
+    return cpu_execute_decoded(cpu, &d);
+}
+
+// 取循环入口 pc 处的机器状态快照
+static void idle_snapshot(const CPU *cpu, uint32_t pc, IDLE_SNAPSHOT *snap) {
+    snap->pc = pc;
+    memcpy(snap->regs, cpu->regs, sizeof(snap->regs));
+    snap->ret_reg = cpu->ret_reg;
+    snap->epoch = cpu->idle.epoch;
+    snap->stim_changes = cpu->stim.changes;
+    snap->timer_next = cpu->timers.next;
+    snap->time = cpu->inst_retired;
+    snap->misses = get_signal_miss_count();
+}
+
+/*
+ * cpu_idle_skip
+ * 作用：程序在空转时（每遍 n 条指令、每遍 misses 次 load 未命中），把仿真时间按整遍直接推进到
+ *       下一个外部事件之前，结果与逐条执行相同。
+ * 行为：
+ *   - 下一个事件为最早的定时器到期与下一段波形激励变化；事件所在的那一遍仍逐条执行，
+ *     定时器在原来的那条指令到期，激励变化在原来的周期写入信号存储；
+ *   - 跳过的周期内每遍的寄存器与采样都相同，下一次采样时由 signal_store_cycle 按时间跳跃补齐；
+ *   - 没有待发生的事件时不跳过（程序照常空转）。
+ * 示例：
+ *   timer0 阈值 4000000000、程序在 "load; jmpc" 循环中等待信号 => 一次跳到到期前的最后一遍
+ */
+static void cpu_idle_skip(CPU *cpu, uint64_t n, uint64_t misses) {
+    uint64_t now = cpu->inst_retired;
+    uint64_t next = cpu->timers.next;
+    if (cpu->stim.enabled && cpu->stim.next_time < next)
+        next = cpu->stim.next_time;
+    if (next == UINT64_MAX || next <= now + n)
+        return;
+    uint64_t k = (next - 1 - now) / n;
+    cpu->inst_retired += k * n;
+    cpu->inst_skipped += k * n;
+    add_signal_miss_count(k * misses);
+}
+
+/*
+ * cpu_idle_probe
+ * 作用：经向后跳转到达 pc 处时检测空转循环（quiet/summary 级别；线程化内核在块执行前、
+ *       switch 内核在该条指令执行前调用，JIT 代码经链接的向后出口到达后继块前调用）。
+ * 行为：
+ *   - 未取快照时每隔 IDLE_PROBE_INTERVAL 次向后跳转在到达处取一次快照；
+ *   - 再次经向后跳转回到快照的入口时比较：寄存器（含返回地址）相同、期间没有有副作用的块、
+ *     没有激励变化、定时器的最早到期时间不变且未到，则这一遍可以无限重复，交给 cpu_idle_skip 跳过；
+ *     其后重新计数。信号存储懒采样，边沿类指令所需的两次采样都在同一遍内取得（或由时间跳跃按
+ *     当前寄存器补齐），与入口处信号存储的状态无关；
+ *   - 快照的入口在 IDLE_PROBE_SPAN 次向后跳转内没有再到达时放弃（已离开该循环）。
+ */
+void cpu_idle_probe(CPU *cpu, uint32_t pc) {
+    IDLE_PROBE *p = &cpu->idle;
+    if (p->armed) {
+        if (pc != p->snap.pc) {
+            if (++p->wait > IDLE_PROBE_SPAN)
+                p->armed = 0;
+            return;
+        }
+        p->armed = 0;
+        p->cooldown = IDLE_PROBE_INTERVAL;
+        IDLE_SNAPSHOT now;
+        idle_snapshot(cpu, pc, &now);
+        if (now.time > p->snap.time && now.timer_next > now.time
+            && memcmp(now.regs, p->snap.regs, sizeof(now.regs)) == 0 && now.ret_reg == p->snap.ret_reg
+            && now.epoch == p->snap.epoch
+            && now.stim_changes == p->snap.stim_changes && now.timer_next == p->snap.timer_next)
+            cpu_idle_skip(cpu, now.time - p->snap.time, now.misses - p->snap.misses);
+        return;
+    }
+    if (p->cooldown) {
+        p->cooldown--;
+        return;
+    }
+    idle_snapshot(cpu, pc, &p->snap);
+    p->armed = 1;
+    p->wait = 0;
+}
+
+#if defined(TSL_THREADED_CORE) && defined(__GNUC__)
+
+// 线程化主循环按日志级别各实例化一份（cpu_run.inc），逐指令的打印判断在编译期消除；
+// 记录二进制轨迹或 VCD 波形时逐条采样、不打印，单独一份
+#define RUN_NAME   cpu_run_quiet
+#define RUN_LEVEL  LOG_QUIET
+#define RUN_OBSERVE 0
+#include "cpu_run.inc"
+#define RUN_NAME   cpu_run_summary
+#define RUN_LEVEL  LOG_SUMMARY
+#define RUN_OBSERVE 0
+#include "cpu_run.inc"
+#define RUN_NAME   cpu_run_trace
+#define RUN_LEVEL  LOG_TRACE
+#define RUN_OBSERVE 0
+#include "cpu_run.inc"
+#define RUN_NAME   cpu_run_full
+#define RUN_LEVEL  LOG_FULL
+#define RUN_OBSERVE 0
+#include "cpu_run.inc"
+#define RUN_NAME   cpu_run_observe
+#define RUN_LEVEL  LOG_QUIET
+#define RUN_OBSERVE 1
+#include "cpu_run.inc"
+
+/*
+ * cpu_run（线程化内核）
+ * 作用：按当前日志级别选择对应的主循环实例，记录轨迹或波形时使用观察实例。
+ */
+void cpu_run(CPU *cpu) {
+    if (cpu_observing(cpu)) {
+        cpu_run_observe(cpu);
+        return;
+    }
+    switch (g_log_level) {
+        case LOG_QUIET:   cpu_run_quiet(cpu);   break;
+        case LOG_SUMMARY: cpu_run_summary(cpu); break;
+        case LOG_TRACE:   cpu_run_trace(cpu);   break;
+        default:          cpu_run_full(cpu);    break;
+    }
+}
+
+#else
+
+/*
+ * cpu_run（switch 内核）
+ * 作用：可移植的主循环，按记录中的执行函数逐条执行。
+ * 行为：
+ *   - 取指（命中解码缓存）→ 执行 → 记录轨迹/波形或打印寄存器（full 级别）；
+ *   - quiet/summary 级别且不记录轨迹或波形时，经向后跳转到达的指令交给 cpu_idle_probe 检测空转循环，
+ *     执行有副作用的指令时推进副作用计数（与线程化内核按块判断的结果相同）；
+ *   - PC 回到 0 或指令非法时返回。
+ */
+void cpu_run(CPU *cpu) {
+    // 逐条打印或观察时每条指令都有输出，不能跳过空转
+    int idle_skip = g_log_level < LOG_TRACE && !cpu_observing(cpu);
+    uint32_t last_pc = 0;
+    while (1) {
+        uint32_t pc = cpu->pc;
+        const DecodedInst *d = cpu_fetch_decoded(cpu);
+
+        if (idle_skip) {
+            if (!inst_side_effect_free(d->op))
+                cpu->idle.epoch++;
+            else if (pc <= last_pc)
+                cpu_idle_probe(cpu, pc);
+            last_pc = pc;
+        }
+
+        if (!cpu_execute_decoded(cpu, d))
+            break;
+
+        if (cpu_observing(cpu))
+            cpu_observe_retired(cpu, d, pc);
+        else if (LOG_ENABLED(LOG_FULL))
+            dump_registers(cpu);
+
+        if (cpu->pc == 0)
+            break;
+    }
+}
+
+#endif
+
 /*
  * cpu_cleanup
  * 作用：释放CPU相关资源。
  * 行为：
- *   - 释放显示信息表、执行信息表、域信息表、定时器信息表等资源。
+ *   - 释放显示信息表、执行信息表、域信息表、定时器与信号索引等资源，关闭波形激励；
+ *   - 释放基本块缓存、解码缓存与 JIT 代码区，关闭轨迹与波形文件；
+ *   - 清空总线设备表，释放 DRAM 页与镜像映射。
  */
 void cpu_cleanup(CPU *cpu) {
     free_builtin_info_table();
     free_domain_info_table();
+    free_instance_info_table();
+    stimulus_close(&cpu->stim);
+    signal_store_free(&cpu->sig);
+    timer_sched_free(&cpu->timers);
+    free_signal_index();
+    cpu->bus.icache = NULL;
+    block_cache_free(&cpu->bcache);
+    decode_cache_free(&cpu->icache);
+    jit_free(&cpu->jit);
+    trace_close(&cpu->trace);
+    vcd_close(&cpu->vcd);
+    bus_free_devices(&cpu->bus);
+    dram_free(&cpu->bus.dram);
 }
@@ -0,0 +1,111 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "../include/dbg_csr.h"
+#include "../include/info_db.h"
+#include "../include/color.h"
+
+// 返回偏移处寄存器的存储位置，DBG_PC 与未定义的偏移返回 NULL
+static uint32_t* dbg_csr_slot(DBG_CSR* dbg, uint64_t offset) {
+    switch (offset) {
+        case DBG_CTRL:      return &dbg->ctrl;
+        case DBG_BP_ADDR:   return &dbg->bp_addr;
+        case DBG_TRACE_PTR: return &dbg->trace_ptr;
+        default:            return NULL;
+    }
+}
+
+// 偏移处的寄存器是否可写（TSL_DBG_CSRS 的 writable 列）
+static int dbg_csr_writable(uint64_t offset) {
+#define TSL_DBG_CSR_WRITABLE(name, offset, writable) case DBG_##name: return writable;
+    switch (offset) {
+        TSL_DBG_CSRS(TSL_DBG_CSR_WRITABLE)
+        default: return 0;
+    }
+#undef TSL_DBG_CSR_WRITABLE
+}
+
+/*
+ * dbg_csr_load
+ * 作用：读调试 CSR（32 位寄存器，按 4 字节对齐访问）。
+ * 行为：
+ *   - DBG_PC 返回正在执行的 load 指令的 PC（读设备时 PC 已前进到下一条，load 为 4 字节指令，减回去）；
+ *   - 未定义的偏移或非 32 位访问打印错误并返回 0。
+ */
+static uint64_t dbg_csr_load(void* ctx, uint64_t offset, uint64_t size) {
+    DBG_CSR* dbg = (DBG_CSR*)ctx;
+    if (size != 32) {
+        fprintf(stderr, "%s[dbg_csr] unsupported %lu-bit load at offset 0x%lx%s\n", ANSI_RED, (unsigned long)size, (unsigned long)offset, ANSI_RESET);
+        return 0;
+    }
+    if (offset == DBG_PC)
+        return *dbg->pc - DBG_LOAD_LENGTH;
+    uint32_t* slot = dbg_csr_slot(dbg, offset);
+    if (!slot) {
+        fprintf(stderr, "%s[dbg_csr] no register at offset 0x%lx%s\n", ANSI_RED, (unsigned long)offset, ANSI_RESET);
+        return 0;
+    }
+    return *slot;
+}
+
+/*
+ * dbg_csr_store
+ * 作用：写调试 CSR。
+ * 行为：
+ *   - DBG_CTRL 只保留低 8 位；step/resume 为自清零位，写入后读回为 0，同时清除 halt；
+ *     这些位只影响读回的值，不控制执行；
+ *   - TSL_DBG_CSRS 中不可写（DBG_PC）或未定义的偏移、非 32 位访问打印错误并忽略。
+ */
+static void dbg_csr_store(void* ctx, uint64_t offset, uint64_t size, uint64_t value) {
+    DBG_CSR* dbg = (DBG_CSR*)ctx;
+    uint32_t* slot = size == 32 && dbg_csr_writable(offset) ? dbg_csr_slot(dbg, offset) : NULL;
+    if (!slot) {
+        fprintf(stderr, "%s[dbg_csr] ignored %lu-bit store at offset 0x%lx%s\n", ANSI_RED, (unsigned long)size, (unsigned long)offset, ANSI_RESET);
+        return;
+    }
+    if (offset == DBG_CTRL) {
+        value &= DBG_CTRL_MASK;
+        if (value & (DBG_CTRL_STEP | DBG_CTRL_RESUME))
+            value &= ~(uint64_t)(DBG_CTRL_HALT | DBG_CTRL_STEP | DBG_CTRL_RESUME);
+    }
+    *slot = (uint32_t)value;
+}
+
+/*
+ * dbg_csr_attach
+ * 作用：清零调试 CSR 并挂到总线的 DBG_CSR_BASE（--dbg-csr）。
+ * 行为：与信号索引中的地址重叠的 CSR 由信号覆盖（load 读信号，见 cpu_load_signal），挂载时在 stderr 提示一次。
+ * 返回：成功返回1；DRAM（--dram-size）超过 DBG_CSR_BASE 时 CSR 区间落在 DRAM 内，打印错误并返回0；区间冲突时返回0。
+ * 示例：
+ *   dbg_csr_attach(&cpu->dbg, &cpu->bus, &cpu->pc) 后 load r1 = [0xFFF004] => 该 load 指令的 PC
+ */
+int dbg_csr_attach(DBG_CSR* dbg, BUS* bus, const uint32_t* pc) {
+    memset(dbg, 0, sizeof(*dbg));
+    dbg->pc = pc;
+    if (bus->dram.size > DBG_CSR_BASE) {
+        fprintf(stderr, "%s[dbg_csr] --dram-size %lu overlaps the CSRs at 0x%x%s\n",
+                ANSI_RED, (unsigned long)bus->dram.size, DBG_CSR_BASE, ANSI_RESET);
+        return 0;
+    }
+    BUS_DEVICE dev = {
+        .name  = "dbg_csr",
+        .base  = DBG_CSR_BASE,
+        .size  = DBG_CSR_SIZE,
+        .ctx   = dbg,
+        .read  = dbg_csr_load,
+        .write = dbg_csr_store,
+    };
+    if (!bus_register_device(bus, &dev))
+        return 0;
+
+#define TSL_DBG_CSR_SHADOWED(name, offset, writable) \
+    if (signal_exists(DBG_CSR_BASE + offset))         \
+        n += snprintf(shadowed + n, sizeof(shadowed) - n, " DBG_%s(0x%x)", #name, DBG_CSR_BASE + offset);
+    char shadowed[128];
+    int n = 0;
+    TSL_DBG_CSRS(TSL_DBG_CSR_SHADOWED)
+#undef TSL_DBG_CSR_SHADOWED
+    if (n)
+        fprintf(stderr, "%s[dbg_csr] signal addresses take precedence over%s%s\n", ANSI_YELLOW, shadowed, ANSI_RESET);
+    return 1;
+}
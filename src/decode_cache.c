@@ -0,0 +1,66 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/decode_cache.h"
+
+/*
+ * decode_cache_init
+ * 作用：为程序镜像分配解码缓存。
+ * 行为：
+ *   - 按镜像字节数分配槽位数组，全部置为未解码；
+ *   - 槽位在首次执行到该 PC 时懒解码填充。
+ * 返回：成功返回1，分配失败返回0（此时所有取指走非缓存路径）。
+ */
+int decode_cache_init(DECODE_CACHE* dc, uint64_t base, uint64_t size) {
+    decode_cache_free(dc);
+    if (size == 0) return 1;
+    dc->entries = (DecodedInst*)calloc(size, sizeof(DecodedInst));
+    if (!dc->entries) {
+        fprintf(stderr, "[cpu][decode_cache] alloc failed: %lu entries\n", (unsigned long)size);
+        return 0;
+    }
+    dc->base = base;
+    dc->size = size;
+    return 1;
+}
+
+/*
+ * decode_cache_free
+ * 作用：释放解码缓存。
+ */
+void decode_cache_free(DECODE_CACHE* dc) {
+    free(dc->entries);
+    dc->entries = NULL;
+    dc->base = 0;
+    dc->size = 0;
+}
+
+/*
+ * decode_cache_invalidate
+ * 作用：写内存后失效受影响的解码记录。
+ * 行为：
+ *   - 写入区间 [addr, addr+bytes) 前推 7 字节，覆盖起点在前、跨越写入地址的指令；
+ *   - 按 DECODE_LINE_SIZE 对齐到整行，整行槽位置为未解码；
+ *   - 递增代数，使基于旧解码结果构建的基本块失效。
+ * 示例：
+ *   decode_cache_invalidate(dc, 0x00000022, 4) => 失效 0x10-0x2f 两行
+ */
+void decode_cache_invalidate(DECODE_CACHE* dc, uint64_t addr, uint64_t bytes) {
+    if (!dc->entries || bytes == 0) return;
+
+    uint64_t lo = addr - dc->base;
+    uint64_t hi = lo + bytes;
+    if (addr < dc->base) {
+        if (addr + bytes <= dc->base) return;
+        lo = 0;
+        hi = addr + bytes - dc->base;
+    }
+    lo = lo >= DECODE_MAX_INST_LEN - 1 ? lo - (DECODE_MAX_INST_LEN - 1) : 0;
+    if (lo >= dc->size) return;
+
+    lo -= lo % DECODE_LINE_SIZE;
+    hi = (hi + DECODE_LINE_SIZE - 1) / DECODE_LINE_SIZE * DECODE_LINE_SIZE;
+    if (hi > dc->size) hi = dc->size;
+    for (uint64_t i = lo; i < hi; i++) dc->entries[i].valid = 0;
+    dc->generation++;
+}
@@ -2,56 +2,197 @@
 #include <assert.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <execinfo.h>  // For backtrace and backtrace_symbols
 #include <unistd.h>    // For STDOUT_FILENO
+#include <sys/mman.h>
 #include "../include/dram.h"  // Include the header with DRAM_BASE definition
+#include "../include/color.h"
 
+// 读未分配的页时返回 0，不分配
+static inline uint8_t dram_rd(const DRAM* dram, uint64_t off) {
+    const uint8_t* page = dram->pages[off >> DRAM_PAGE_SHIFT];
+    return page ? page[off & DRAM_PAGE_MASK] : 0;
+}
+
+// 首次写入时分配该页（全零）
+static inline void dram_wr(DRAM* dram, uint64_t off, uint8_t value) {
+    uint8_t** page = &dram->pages[off >> DRAM_PAGE_SHIFT];
+    if (!*page) {
+        *page = (uint8_t*)calloc(1, DRAM_PAGE_SIZE);
+        if (!*page) {
+            fprintf(stderr, "%s[dram] out of memory allocating page at 0x%08lx%s\n", ANSI_RED, (unsigned long)(off & ~(uint64_t)DRAM_PAGE_MASK), ANSI_RESET);
+            exit(1);
+        }
+    }
+    (*page)[off & DRAM_PAGE_MASK] = value;
+}
+
+/*
+ * dram_load_split / dram_store_split
+ * 作用：快速路径的慢速分支，按字节（大端）访问，可跨页；写未分配的页时分配。
+ */
+uint64_t dram_load_split(const DRAM* dram, uint64_t off, unsigned bytes) {
+    uint64_t v = 0;
+    for (unsigned i = 0; i < bytes; i++)
+        v = (v << 8) | dram_rd(dram, off + i);
+    return v;
+}
+
+void dram_store_split(DRAM* dram, uint64_t off, unsigned bytes, uint64_t value) {
+    for (unsigned i = 0; i < bytes; i++)
+        dram_wr(dram, off + i, (uint8_t)(value >> (8 * (bytes - 1 - i))));
+}
+
+static size_t page_round(size_t bytes) {
+    return (bytes + DRAM_PAGE_MASK) & ~(size_t)DRAM_PAGE_MASK;
+}
+
+/*
+ * dram_init
+ * 作用：建立 size 字节 DRAM 的页表，不分配任何页。
+ * 行为：size 为 0 或超过 DRAM_MAX_SIZE 时打印错误。
+ * 返回：成功返回1，失败返回0。
+ * 示例：
+ *   dram_init(dram, DRAM_MAX_SIZE) => 1（页表 14544 项，约 114KB）
+ */
+int dram_init(DRAM* dram, uint64_t size) {
+    memset(dram, 0, sizeof(*dram));
+    if (size == 0 || size > DRAM_MAX_SIZE) {
+        fprintf(stderr, "%s[dram] size %lu out of range (1..%llu)%s\n", ANSI_RED, (unsigned long)size, DRAM_MAX_SIZE, ANSI_RESET);
+        return 0;
+    }
+    dram->npages = (uint32_t)((size + DRAM_PAGE_MASK) >> DRAM_PAGE_SHIFT);
+    dram->pages = (uint8_t**)calloc(dram->npages, sizeof(uint8_t*));
+    if (!dram->pages) {
+        fprintf(stderr, "%s[dram] out of memory%s\n", ANSI_RED, ANSI_RESET);
+        return 0;
+    }
+    dram->size = size;
+    return 1;
+}
+
+/*
+ * dram_parse_size
+ * 作用：解析 --dram-size 参数，支持 K/M 后缀（1024 进制）与 max（DRAM_MAX_SIZE）。
+ * 返回：合法返回1并写入 size，否则返回0。
+ * 示例：
+ *   dram_parse_size("32K", &n) => 1, n = 32768
+ *   dram_parse_size("max", &n) => 1, n = 59572224
+ */
+int dram_parse_size(const char* s, uint64_t* size) {
+    if (strcmp(s, "max") == 0) {
+        *size = DRAM_MAX_SIZE;
+        return 1;
+    }
+    char* end;
+    unsigned long long n = strtoull(s, &end, 0);
+    if (end == s)
+        return 0;
+    if (*end == 'K' || *end == 'k')
+        n <<= 10, end++;
+    else if (*end == 'M' || *end == 'm')
+        n <<= 20, end++;
+    if (*end != '\0' || n == 0 || n > DRAM_MAX_SIZE)
+        return 0;
+    *size = n;
+    return 1;
+}
+
+static int read_all(int fd, uint8_t* dst, size_t bytes) {
+    while (bytes > 0) {
+        ssize_t n = read(fd, dst, bytes);
+        if (n <= 0)
+            return 0;
+        dst += n;
+        bytes -= (size_t)n;
+    }
+    return 1;
+}
+
+/*
+ * dram_map_image
+ * 作用：将镜像文件的前 bytes 字节作为 DRAM 起始处的内容，不经过中间缓冲区与拷贝。
+ * 行为：
+ *   - 以 MAP_PRIVATE 映射文件：读取共享页缓存，程序写入时按页写时复制，不影响文件；
+ *     无法映射（如管道）时读入同样大小的匿名映射；
+ *   - 页表前 ceil(bytes / DRAM_PAGE_SIZE) 项直接指向映射中的页，末页文件结尾之后的字节为 0；
+ *   - bytes 须不超过 dram->size。
+ * 返回：成功返回1，读取失败返回0。
+ */
+int dram_map_image(DRAM* dram, int fd, size_t bytes) {
+    size_t mapped = page_round(bytes);
+    void* p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+        p = mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED)
+            return 0;
+        if (!read_all(fd, (uint8_t*)p, bytes)) {
+            munmap(p, mapped);
+            return 0;
+        }
+    }
+    dram->image = (uint8_t*)p;
+    dram->image_bytes = bytes;
+    for (size_t i = 0; i < mapped >> DRAM_PAGE_SHIFT; i++)
+        dram->pages[i] = dram->image + (i << DRAM_PAGE_SHIFT);
+    return 1;
+}
+
+/*
+ * dram_free
+ * 作用：释放已分配的页、解除镜像映射并释放页表；未初始化时无操作。
+ */
+void dram_free(DRAM* dram) {
+    size_t mapped = page_round(dram->image_bytes);
+    for (uint32_t i = 0; dram->pages && i < dram->npages; i++) {
+        uint8_t* page = dram->pages[i];
+        if (page && !(dram->image && page >= dram->image && page < dram->image + mapped))
+            free(page);
+    }
+    if (dram->image)
+        munmap(dram->image, mapped);
+    free(dram->pages);
+    memset(dram, 0, sizeof(*dram));
+}
+
+// 各宽度的加载/存储：不检查边界（由 dram_load/dram_store 检查），走快速路径
 uint64_t dram_load_8(DRAM* dram, uint64_t addr){
-    return (uint64_t) dram->mem[addr - DRAM_BASE];
+    return dram_fast_load_8(dram, addr);
 }
 
 uint64_t dram_load_16(DRAM* dram, uint64_t addr){
-    return ((uint64_t)dram->mem[addr-DRAM_BASE] << 8) |
-           (uint64_t)dram->mem[addr-DRAM_BASE + 1];
+    return dram_fast_load_16(dram, addr);
 }
 
 uint64_t dram_load_32(DRAM* dram, uint64_t addr){
-    return ((uint64_t)dram->mem[addr-DRAM_BASE] << 24) |
-           ((uint64_t)dram->mem[addr-DRAM_BASE + 1] << 16) |
-           ((uint64_t)dram->mem[addr-DRAM_BASE + 2] << 8) |
-           (uint64_t)dram->mem[addr-DRAM_BASE + 3];
+    return dram_fast_load_32(dram, addr);
 }
 
 uint64_t dram_load_64(DRAM* dram, uint64_t addr){
-    return ((uint64_t)dram->mem[addr-DRAM_BASE] << 56) |
-           ((uint64_t)dram->mem[addr-DRAM_BASE + 1] << 48) |
-           ((uint64_t)dram->mem[addr-DRAM_BASE + 2] << 40) |
-           ((uint64_t)dram->mem[addr-DRAM_BASE + 3] << 32) |
-           ((uint64_t)dram->mem[addr-DRAM_BASE + 4] << 24) |
-           ((uint64_t)dram->mem[addr-DRAM_BASE + 5] << 16) |
-           ((uint64_t)dram->mem[addr-DRAM_BASE + 6] << 8) |
-           (uint64_t)dram->mem[addr-DRAM_BASE + 7];
+    return dram_fast_load_64(dram, addr);
 }
 
 /*
  * dram_load
- * 作用：从DRAM加载数据。
+ * 作用：从DRAM加载数据（检查路径，地址来自程序、范围未知时使用）。
  * 行为：
- *   - 根据地址和大小，调用相应的加载函数；
+ *   - 越界、跨越边界或宽度非法时打印诊断（含调用栈）并返回 0；
+ *   - 根据地址和大小，调用相应的加载函数，未分配的页读为 0；
  *   - 返回加载到的数据。
  * 示例：
  *   dram_load(dram, 0x00001000, 32) => 0x10001111000050ee000060ff000011f1
  */
 uint64_t dram_load(DRAM* dram, uint64_t addr, uint64_t size) {
     // Check if address is within DRAM bounds
-    if (addr >= DRAM_SIZE) {
-        fprintf(stderr, "[-] ERROR: Address 0x%08lx is outside DRAM bounds (0x%08x)\n", 
-                addr, DRAM_SIZE);
+    if (addr >= dram->size) {
+        fprintf(stderr, "[-] ERROR: Address 0x%08lx is outside DRAM bounds (0x%08lx)\n", 
+                addr, dram->size);
         return 0;
     }
     
     // Check if access would cross DRAM boundary
-    if (addr + (size / 8) > DRAM_SIZE) {
+    if (addr + (size / 8) > dram->size) {
         fprintf(stderr, "[-] ERROR: Access at 0x%08lx with size %lu would cross DRAM boundary\n", 
                 addr, size);
         return 0;
@@ -88,42 +229,37 @@ uint64_t dram_load(DRAM* dram, uint64_t addr, uint64_t size) {
 }
 
 void dram_store_8(DRAM* dram, uint64_t addr, uint64_t value) {
-    dram->mem[addr-DRAM_BASE] = (uint8_t) (value & 0xff);
+    dram_fast_store_8(dram, addr, value);
 }
 
 void dram_store_16(DRAM* dram, uint64_t addr, uint64_t value) {
-    dram->mem[addr-DRAM_BASE]     = (uint8_t)((value >> 8) & 0xff);
-    dram->mem[addr-DRAM_BASE + 1] = (uint8_t)(value & 0xff);
+    dram_fast_store_16(dram, addr, value);
 }
 
 void dram_store_32(DRAM* dram, uint64_t addr, uint64_t value) {
-    dram->mem[addr-DRAM_BASE]     = (uint8_t)((value >> 24) & 0xff);
-    dram->mem[addr-DRAM_BASE + 1] = (uint8_t)((value >> 16) & 0xff);
-    dram->mem[addr-DRAM_BASE + 2] = (uint8_t)((value >> 8) & 0xff);
-    dram->mem[addr-DRAM_BASE + 3] = (uint8_t)(value & 0xff);
+    dram_fast_store_32(dram, addr, value);
 }
 
 void dram_store_64(DRAM* dram, uint64_t addr, uint64_t value) {
-    dram->mem[addr-DRAM_BASE]     = (uint8_t)((value >> 56) & 0xff);
-    dram->mem[addr-DRAM_BASE + 1] = (uint8_t)((value >> 48) & 0xff);
-    dram->mem[addr-DRAM_BASE + 2] = (uint8_t)((value >> 40) & 0xff);
-    dram->mem[addr-DRAM_BASE + 3] = (uint8_t)((value >> 32) & 0xff);
-    dram->mem[addr-DRAM_BASE + 4] = (uint8_t)((value >> 24) & 0xff);
-    dram->mem[addr-DRAM_BASE + 5] = (uint8_t)((value >> 16) & 0xff);
-    dram->mem[addr-DRAM_BASE + 6] = (uint8_t)((value >> 8) & 0xff);
-    dram->mem[addr-DRAM_BASE + 7] = (uint8_t)(value & 0xff);
+    dram_fast_store_64(dram, addr, value);
 }
 
 /*
  * dram_store
  * 作用：向DRAM存储数据。
  * 行为：
- *   - 根据地址和大小，调用相应的存储函数；
+ *   - 地址越界或跨越 DRAM 边界时打印错误并忽略；
+ *   - 根据地址和大小，调用相应的存储函数（首次写入的页此时分配）；
  *   - 无返回值。
  * 示例：
  *   dram_store(dram, 0x00001000, 32, 0x10001111000050ee000060ff000011f1) => 无返回值
  */
 void dram_store(DRAM* dram, uint64_t addr, uint64_t size, uint64_t value) {
+    if (addr >= dram->size || addr + (size / 8) > dram->size) {
+        fprintf(stderr, "[-] ERROR: Store at 0x%08lx with size %lu is outside DRAM bounds (0x%08lx)\n",
+                addr, size, dram->size);
+        return;
+    }
     switch (size) {
         case 8:  dram_store_8(dram, addr, value);  break;
         case 16: dram_store_16(dram, addr, value); break;
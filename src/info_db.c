@@ -2,13 +2,21 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <inttypes.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "../include/color.h"
 #include "../include/info_db.h"
+#include "../include/log.h"
 
 
-// 示例信号表，可以根据实际需求扩展
+static char info_base_dir[512] = "examples";
+
+// 示例信号表，可以根据实际需求扩展（未在 signal_split.db 中出现的地址也可 load）
 struct signal_entry signal_table[] = {
     {0x00000004, 0x1001cccc},
     {0x00001000, 0x10001111},
@@ -23,37 +31,566 @@ struct signal_entry signal_table[] = {
 
 const int signal_table_size = sizeof(signal_table) / sizeof(signal_table[0]);
 
+//=====================================================================================
+//   编译库映射：首个使用者打开 info.tdb 时整体只读映射并校验文件头与各区范围，
+//   各表与拆分信号表直接引用映射中的数据，最后一个使用者释放时解除映射
+//=====================================================================================
+static const uint8_t* info_db_map = NULL;
+static size_t info_db_size = 0;
+static int info_db_users = 0;
+static int info_db_unusable = 0;         // 本目录的编译库已判定不可用，不再重复打开与提示
+
+// 编译库所依据的文本表；其中任一比编译库新时编译库视为过期
+static const char* const info_db_sources[] = { "builtin_info.db", "domain_info.db", "instance_info.db", "signal_split.db" };
+
+static int info_db_range(uint32_t off, uint64_t len) {
+    return off <= info_db_size && len <= info_db_size - off;
+}
+
+// 字符串区须落在文件内并以 '\0' 结尾
+static int info_db_strings_ok(uint32_t off, uint32_t size) {
+    return info_db_range(off, size) && (size == 0 || info_db_map[off + size - 1] == '\0');
+}
+
+static int info_db_table_ok(const INFO_DB_TABLE* d) {
+    return info_db_range(d->entries, (uint64_t)d->count * sizeof(INFO_DB_ENTRY))
+        && info_db_range(d->direct, (uint64_t)d->direct_size * sizeof(uint32_t))
+        && info_db_range(d->args, (uint64_t)d->nargs * sizeof(uint32_t))
+        && d->entries % 4 == 0 && d->direct % 4 == 0 && d->args % 4 == 0
+        && info_db_strings_ok(d->strings, d->strings_size);
+}
+
+static int info_db_valid() {
+    const INFO_DB_HEADER* h = (const INFO_DB_HEADER*)info_db_map;
+    return info_db_size >= sizeof(*h) && memcmp(h->magic, INFO_DB_MAGIC, sizeof(h->magic)) == 0
+        && h->version == INFO_DB_VERSION && h->size == info_db_size
+        && info_db_table_ok(&h->builtin) && info_db_table_ok(&h->domain) && info_db_table_ok(&h->instance)
+        && info_db_range(h->splits, (uint64_t)h->nsplits * sizeof(INFO_DB_SPLIT)) && h->splits % 4 == 0
+        && info_db_strings_ok(h->split_strings, h->split_strings_size);
+}
+
+/*
+ * info_db_acquire
+ * 作用：取得 DB 目录下编译库的映射（引用计数加一）。
+ * 行为：
+ *   - 文件不存在时静默返回 NULL；比任一文本 *.db 旧或校验失败时打印提示并返回 NULL；
+ *   - 调用方在返回 NULL 时回退到文本解析。
+ */
+static const uint8_t* info_db_acquire() {
+    if (info_db_map) {
+        info_db_users++;
+        return info_db_map;
+    }
+    if (info_db_unusable)
+        return NULL;
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s", info_base_dir, INFO_DB_FILE);
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0)
+        return NULL;
+    if (fstat(fd, &st) != 0 || st.st_size == 0 || (uint64_t)st.st_size > UINT32_MAX) {
+        close(fd);
+        return NULL;
+    }
+    for (size_t i = 0; i < sizeof(info_db_sources) / sizeof(info_db_sources[0]); i++) {
+        char src[1024];
+        struct stat ss;
+        snprintf(src, sizeof(src), "%s/%s", info_base_dir, info_db_sources[i]);
+        if (stat(src, &ss) == 0 && (ss.st_mtim.tv_sec > st.st_mtim.tv_sec
+            || (ss.st_mtim.tv_sec == st.st_mtim.tv_sec && ss.st_mtim.tv_nsec > st.st_mtim.tv_nsec))) {
+            fprintf(stderr, "[info_db][tdb] %s is older than %s, using text DB\n", path, info_db_sources[i]);
+            info_db_unusable = 1;
+            close(fd);
+            return NULL;
+        }
+    }
+    void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+        return NULL;
+    info_db_map = (const uint8_t*)p;
+    info_db_size = (size_t)st.st_size;
+    if (!info_db_valid()) {
+        fprintf(stderr, "[info_db][tdb] %s is not a version %d compiled DB, using text DB\n", path, INFO_DB_VERSION);
+        munmap(p, info_db_size);
+        info_db_unusable = 1;
+        info_db_map = NULL;
+        info_db_size = 0;
+        return NULL;
+    }
+    info_db_users = 1;
+    return info_db_map;
+}
+
+static void info_db_release() {
+    if (info_db_map && --info_db_users == 0) {
+        munmap((void*)info_db_map, info_db_size);
+        info_db_map = NULL;
+        info_db_size = 0;
+    }
+}
+
+//=====================================================================================
+//   信号索引：地址 -> 值的开放寻址哈希表（线性探测），地址与值相邻存放，
+//   一次探测只访问一个 8 字节槽；容量为 2 的幂且装载率不超过 1/2
+//=====================================================================================
+#define SIGNAL_SLOT_EMPTY 0xFFFFFFFFu
+
+static struct signal_entry* signal_slots = NULL;
+static uint32_t signal_slot_mask = 0;
+static uint32_t signal_slot_shift = 32;
+static int signal_count = 0;
+static uint64_t signal_miss_count = 0;
+static uint32_t signal_first_miss = 0;
+
+static inline uint32_t signal_hash(uint32_t addr) {
+    return (addr * 0x9E3779B1u) >> signal_slot_shift;
+}
+
+// 插入地址（已存在时保留原值），返回是否新增
+static int signal_index_insert(uint32_t addr, uint32_t value) {
+    uint32_t i = signal_hash(addr);
+    while (signal_slots[i].addr != SIGNAL_SLOT_EMPTY) {
+        if (signal_slots[i].addr == addr)
+            return 0;
+        i = (i + 1) & signal_slot_mask;
+    }
+    signal_slots[i].addr = addr;
+    signal_slots[i].value = value;
+    signal_count++;
+    return 1;
+}
+
+static int signal_index_alloc(int n) {
+    uint32_t cap = 16, bits = 4;
+    while (cap < (uint32_t)n * 2) {
+        cap <<= 1;
+        bits++;
+    }
+    signal_slots = (struct signal_entry*)malloc(cap * sizeof(struct signal_entry));
+    if (!signal_slots)
+        return 0;
+    memset(signal_slots, 0xFF, cap * sizeof(struct signal_entry));
+    signal_slot_mask = cap - 1;
+    signal_slot_shift = 32 - bits;
+    signal_count = 0;
+    return 1;
+}
+
+// 地址在索引中的值槽；不存在返回 NULL（索引建成后不再扩容，指针一直有效）
+static uint32_t* signal_index_slot(uint32_t addr) {
+    uint32_t i = signal_hash(addr);
+    while (signal_slots[i].addr != SIGNAL_SLOT_EMPTY) {
+        if (signal_slots[i].addr == addr)
+            return &signal_slots[i].value;
+        i = (i + 1) & signal_slot_mask;
+    }
+    return NULL;
+}
+
+static SIGNAL_SPLIT* signal_splits = NULL;
+static int signal_split_count = 0;
+static int signal_splits_mapped = 0;     // 名称与拆分字指向编译库映射
+
+//=====================================================================================
+//   宽信号装配：拆分信号从基址起按 32 位连续编址（基址 + 4k 为位 [32k+31:32k]）。
+//   建索引时为每个信号编译装配计划：源拆分字与目标地址在索引中的值槽及位宽掩码，
+//   所有信号的计划拼成一张扁平表；拆分字的值变化后在周期边界整批执行一次，
+//   load 基址 + 4k 直接命中装配好的值，访问时不再逐字拼装
+//=====================================================================================
+static uint32_t** gather_src = NULL;
+static uint32_t** gather_dst = NULL;
+static uint32_t*  gather_mask = NULL;
+static uint32_t   gather_count = 0;
+static int        gather_stale = 0;
+
+static int u32_cmp(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+// 信号 sig 装配后的 32 位字数（不超过拆分字数）
+static uint32_t signal_split_chunks(const SIGNAL_SPLIT* sig) {
+    uint32_t n = (sig->width + 31) / 32;
+    return n < sig->nwords ? n : sig->nwords;
+}
+
+/*
+ * compile_gather_plans
+ * 作用：插入各拆分信号的装配地址（基址 + 4k）并编译装配计划。
+ * 行为：
+ *   - 装配地址与对应拆分字相同（拆分字本就从基址连续排列）时不需要装配；
+ *   - 装配地址与内置示例信号重合时以装配值为准，与其他拆分字重合时不装配，结束时汇总一次；
+ *   - 最高字按位宽截掉多余的位。
+ */
+static void compile_gather_plans() {
+    uint32_t total = 0, nwords = 0, overlaps = 0;
+    for (int i = 0; i < signal_split_count; i++) {
+        total += signal_split_chunks(&signal_splits[i]);
+        nwords += signal_splits[i].nwords;
+    }
+    gather_src = (uint32_t**)malloc((total + 1) * sizeof(uint32_t*));
+    gather_dst = (uint32_t**)malloc((total + 1) * sizeof(uint32_t*));
+    gather_mask = (uint32_t*)malloc((total + 1) * sizeof(uint32_t));
+    uint32_t* words = (uint32_t*)malloc((nwords + 1) * sizeof(uint32_t));
+    if (!gather_src || !gather_dst || !gather_mask || !words) {
+        fprintf(stderr, "[info_db][signal] out of memory\n");
+        free(words);
+        return;
+    }
+    // 全部拆分字地址排序，判断装配地址是否与拆分字重合
+    nwords = 0;
+    for (int i = 0; i < signal_split_count; i++)
+        for (uint32_t w = 0; w < signal_splits[i].nwords; w++)
+            words[nwords++] = signal_splits[i].words[w];
+    qsort(words, nwords, sizeof(uint32_t), u32_cmp);
+
+    for (int i = 0; i < signal_split_count; i++) {
+        const SIGNAL_SPLIT* sig = &signal_splits[i];
+        for (uint32_t k = 0; k < signal_split_chunks(sig); k++) {
+            uint32_t dst = sig->addr + 4 * k;
+            uint32_t bits = sig->width - 32 * k;
+            if (dst == sig->words[k] || sig->words[k] == SIGNAL_SLOT_EMPTY)
+                continue;
+            if (dst == SIGNAL_SLOT_EMPTY || bsearch(&dst, words, nwords, sizeof(uint32_t), u32_cmp)) {
+                overlaps++;
+                continue;
+            }
+            signal_index_insert(dst, 0);
+            gather_src[gather_count] = signal_index_slot(sig->words[k]);
+            gather_dst[gather_count] = signal_index_slot(dst);
+            gather_mask[gather_count] = bits >= 32 ? 0xFFFFFFFFu : (1u << bits) - 1;
+            gather_count++;
+        }
+    }
+    free(words);
+    if (overlaps)
+        fprintf(stderr, "[info_db][signal] %u wide-signal words overlap split words, not assembled\n", overlaps);
+    gather_stale = 1;
+    signal_gather_run();
+}
+
+/*
+ * signal_gather_run
+ * 作用：拆分字的值变化后整批执行全部装配计划（波形激励在周期边界推进后调用）；无变化时直接返回。
+ */
+void signal_gather_run() {
+    if (!gather_stale)
+        return;
+    for (uint32_t i = 0; i < gather_count; i++)
+        *gather_dst[i] = *gather_src[i] & gather_mask[i];
+    gather_stale = 0;
+}
+
+/*
+ * parse_signal_split
+ * 作用：解析 signal_split.db 的一行：{"NAME", {0xADDR, WIDTH, WORD_BYTES, [0xW0, 0xW1, ...]}}。
+ * 行为：装配计划与波形激励都按 32 位拆分字处理，WORD_BYTES 不是 SIGNAL_WORD_BYTES 时打印警告并跳过该信号。
+ * 返回：成功返回1并填充 sig（name/words 为新分配内存），格式不符或拆分字宽度不支持返回0。
+ */
+static int parse_signal_split(const char* line, SIGNAL_SPLIT* sig) {
+    const char* name = strchr(line, '"');
+    const char* name_end = name ? strchr(name + 1, '"') : NULL;
+    const char* p = name_end ? strchr(name_end, '{') : NULL;
+    if (!p)
+        return 0;
+    unsigned long addr, width, word_bytes;
+    char* end;
+    addr = strtoul(p + 1, &end, 0);
+    if (end == p + 1 || sscanf(end, " , %lu , %lu", &width, &word_bytes) != 2)
+        return 0;
+    const char* q = strchr(end, '[');
+    if (!q)
+        return 0;
+    if (word_bytes != SIGNAL_WORD_BYTES) {
+        fprintf(stderr, "[info_db][signal] %.*s: %lu-byte split words not supported (only %u), skipped\n",
+                (int)(name_end - name - 1), name + 1, word_bytes, SIGNAL_WORD_BYTES);
+        return 0;
+    }
+
+    uint32_t n = 0;
+    for (const char* c = q; *c && *c != ']'; c++)
+        n += *c == ',';
+    sig->words = (uint32_t*)malloc((n + 1) * sizeof(uint32_t));
+    if (!sig->words)
+        return 0;
+    sig->nwords = 0;
+    for (q++; ; q = end + 1) {
+        while (*q == ' ')
+            q++;
+        unsigned long w = strtoul(q, &end, 0);
+        if (end == q)
+            break;
+        sig->words[sig->nwords++] = (uint32_t)w;
+        while (*end == ' ')
+            end++;
+        if (*end != ',')
+            break;
+    }
+    sig->name = strndup(name + 1, (size_t)(name_end - name - 1));
+    sig->addr = (uint32_t)addr;
+    sig->width = (uint32_t)width;
+    sig->word_bytes = (uint32_t)word_bytes;
+    return 1;
+}
+
+static int signal_split_cmp(const void* a, const void* b) {
+    return strcmp(((const SIGNAL_SPLIT*)a)->name, ((const SIGNAL_SPLIT*)b)->name);
+}
+
+// 逐行解析 signal_split.db 并按名称排序；文件缺失时静默得到空表
+static void load_signal_splits_text() {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/signal_split.db", info_base_dir);
+    FILE* file = fopen(path, "r");
+    char* line = NULL;
+    size_t cap = 0;
+    int lines = 0;
+    if (file) {
+        while (getline(&line, &cap, file) > 0) {
+            if (line[0] != '{')
+                continue;
+            SIGNAL_SPLIT sig;
+            if (!parse_signal_split(line, &sig))
+                continue;
+            SIGNAL_SPLIT* grown = (SIGNAL_SPLIT*)realloc(signal_splits, (size_t)(lines + 1) * sizeof(SIGNAL_SPLIT));
+            if (!grown) {
+                free(sig.name);
+                free(sig.words);
+                break;
+            }
+            signal_splits = grown;
+            signal_splits[lines++] = sig;
+        }
+        fclose(file);
+    }
+    free(line);
+    signal_split_count = lines;
+    if (lines)
+        qsort(signal_splits, (size_t)lines, sizeof(SIGNAL_SPLIT), signal_split_cmp);
+}
+
+// 拆分信号表直接引用编译库中的名称与拆分字（只分配 SIGNAL_SPLIT 数组本身）；编译库不可用时返回0
+static int map_signal_splits() {
+    const uint8_t* map = info_db_acquire();
+    if (!map)
+        return 0;
+    const INFO_DB_HEADER* h = (const INFO_DB_HEADER*)map;
+    const INFO_DB_SPLIT* d = (const INFO_DB_SPLIT*)(map + h->splits);
+    signal_splits = (SIGNAL_SPLIT*)malloc((h->nsplits + 1) * sizeof(SIGNAL_SPLIT));
+    for (uint32_t i = 0; signal_splits && i < h->nsplits; i++) {
+        if (d[i].name >= h->split_strings_size || d[i].words % 4 != 0
+            || d[i].word_bytes != SIGNAL_WORD_BYTES
+            || !info_db_range(d[i].words, (uint64_t)d[i].nwords * sizeof(uint32_t))) {
+            fprintf(stderr, "[info_db][tdb] signal %u out of range, using text DB\n", i);
+            free(signal_splits);
+            signal_splits = NULL;
+            break;
+        }
+        signal_splits[i].name = (char*)(map + h->split_strings + d[i].name);
+        signal_splits[i].addr = d[i].addr;
+        signal_splits[i].width = d[i].width;
+        signal_splits[i].word_bytes = d[i].word_bytes;
+        signal_splits[i].nwords = d[i].nwords;
+        signal_splits[i].words = (uint32_t*)(map + d[i].words);
+    }
+    if (!signal_splits) {
+        info_db_release();
+        return 0;
+    }
+    signal_split_count = (int)h->nsplits;
+    signal_splits_mapped = 1;
+    return 1;
+}
+
+static void free_signal_splits() {
+    for (int i = 0; !signal_splits_mapped && i < signal_split_count; i++) {
+        free(signal_splits[i].name);
+        free(signal_splits[i].words);
+    }
+    if (signal_splits_mapped)
+        info_db_release();
+    free(signal_splits);
+    signal_splits = NULL;
+    signal_split_count = 0;
+    signal_splits_mapped = 0;
+}
+
+/*
+ * init_signal_index
+ * 作用：建立信号地址索引与按名称排序的拆分信号表。
+ * 行为：
+ *   - 插入内置示例信号表的地址与值；
+ *   - 拆分信号取自编译库，否则逐行解析 signal_split.db（文件缺失时静默跳过）；插入每个信号的拆分字地址
+ *     （没有拆分字时为基址），值为 0，再插入装配地址并编译装配计划；
+ *   - 地址 0xFFFFFFFF 为索引的空槽标记（SIGNAL_SLOT_EMPTY），用到它的拆分字不插入并在 stderr 提示；
+ *   - 按条目总数分配容量后一次插入，不再扩容；拆分信号表按名称排序供 find_signal_split 查找。
+ */
+void init_signal_index() {
+    if (!map_signal_splits())
+        load_signal_splits_text();
+    int addrs = 0;
+    for (int i = 0; i < signal_split_count; i++)
+        addrs += 1 + 2 * (int)signal_splits[i].nwords;
+
+    if (!signal_index_alloc(signal_table_size + addrs)) {
+        fprintf(stderr, "[info_db][signal] out of memory\n");
+        return;
+    }
+    for (int i = 0; i < signal_table_size; i++)
+        signal_index_insert(signal_table[i].addr, signal_table[i].value);
+    for (int i = 0; i < signal_split_count; i++) {
+        const SIGNAL_SPLIT* sig = &signal_splits[i];
+        int reserved = sig->nwords == 0 && sig->addr == SIGNAL_SLOT_EMPTY;
+        if (sig->nwords == 0 && !reserved)
+            signal_index_insert(sig->addr, 0);
+        for (uint32_t w = 0; w < sig->nwords; w++) {
+            if (sig->words[w] == SIGNAL_SLOT_EMPTY)
+                reserved = 1;
+            else
+                signal_index_insert(sig->words[w], 0);
+        }
+        if (reserved)
+            fprintf(stderr, "[info_db][signal] %s: address 0x%x is reserved for empty index slots, skipped\n", sig->name, SIGNAL_SLOT_EMPTY);
+    }
+    compile_gather_plans();
+}
+
+/*
+ * free_signal_index
+ * 作用：释放信号索引与拆分信号表；运行中有未命中的 load 时在 stderr 汇总一次（次数与首个地址）。
+ */
+void free_signal_index() {
+    if (signal_miss_count)
+        fprintf(stderr, "[cpu][signal] not found: %" PRIu64 " loads (first 0x%x)\n", signal_miss_count, signal_first_miss);
+    free(signal_slots);
+    signal_slots = NULL;
+    signal_count = 0;
+    signal_miss_count = 0;
+    free_signal_splits();
+    free(gather_src);
+    free(gather_dst);
+    free(gather_mask);
+    gather_src = gather_dst = NULL;
+    gather_mask = NULL;
+    gather_count = 0;
+}
+
+/*
+ * find_signal_split
+ * 作用：按完整层次名（如 "top.op"）二分查找 signal_split.db 中的信号。
+ * 返回：找到返回表项，否则返回 NULL。
+ */
+const SIGNAL_SPLIT* find_signal_split(const char* name) {
+    if (!signal_split_count)
+        return NULL;
+    SIGNAL_SPLIT key = { .name = (char*)name };
+    return (const SIGNAL_SPLIT*)bsearch(&key, signal_splits, (size_t)signal_split_count, sizeof(SIGNAL_SPLIT), signal_split_cmp);
+}
+
+/*
+ * set_signal_value
+ * 作用：更新索引中已有地址的信号值（波形激励回放时使用），之后的 signal_gather_run 重新装配宽信号。
+ * 返回：地址在索引中返回1，否则返回0（不新增）。
+ */
+int set_signal_value(uint32_t addr, uint32_t value) {
+    uint32_t* slot = signal_slots ? signal_index_slot(addr) : NULL;
+    if (!slot)
+        return 0;
+    *slot = value;
+    gather_stale = 1;
+    return 1;
+}
+
+/*
+ * signal_exists
+ * 作用：判断地址是否在信号索引中（调试 CSR 等总线设备与信号地址重叠时，信号优先）。
+ */
+int signal_exists(uint32_t addr) {
+    return signal_slots && signal_index_slot(addr) != NULL;
+}
+
 /*
  * get_signal_value
  * 作用：根据信号地址查询信号值。
  * 行为：
- *   - 遍历信号表，查找匹配的地址；
+ *   - 在信号索引中哈希查找，O(1)；
  *   - 如果找到，返回对应值；
- *   - 如果未找到，打印错误日志并返回 0。
+ *   - 如果未找到，计入未命中次数（结束时汇总，不逐次打印）并返回 0。
  * 示例：
  *   get_signal_value(0x00000004) => 0x1001cccc
  *   get_signal_value(0x00001000) => 0x10001111
  *   get_signal_value(0x00008192) => 0x000044c4
- *   get_signal_value(0x00009000) => 错误日志，返回 0
+ *   get_signal_value(0x00009000) => 计入未命中，返回 0
  */
 uint32_t get_signal_value(uint32_t addr) {
-    for (int i = 0; i < signal_table_size; ++i) {
-        if (signal_table[i].addr == addr)
-            return signal_table[i].value;
+    if (signal_slots) {
+        uint32_t i = signal_hash(addr);
+        while (signal_slots[i].addr != SIGNAL_SLOT_EMPTY) {
+            if (signal_slots[i].addr == addr)
+                return signal_slots[i].value;
+            i = (i + 1) & signal_slot_mask;
+        }
     }
-    fprintf(stderr, "[cpu][signal] not found: 0x%x\n", addr);
+    if (signal_miss_count++ == 0)
+        signal_first_miss = addr;
     return 0;
 }
 
-typedef struct builtin_info_entry {
+/*
+ * get_signal_miss_count / add_signal_miss_count
+ * 作用：读取与补记 load 未命中次数；跳过空转循环时按每遍的未命中次数补齐，结束汇总与逐条执行一致。
+ */
+uint64_t get_signal_miss_count() {
+    return signal_miss_count;
+}
+
+void add_signal_miss_count(uint64_t n) {
+    signal_miss_count += n;
+}
+
+//=====================================================================================
+//   信息表：优先使用编译库中的条目与字符串区；否则为文本 *.db 建立按 ID 排序的行索引，
+//   条目在首次查询时（或加载镜像后按其引用的 ID 预取时）才解析，字符串拷入预留的字符串池，
+//   类型字符串驻留（相同的类型只存一份）。两种来源的条目格式相同（INFO_DB_ENTRY），
+//   第 j 个 ID 的条目为 entries[j]，ID 较密集时另有直接索引
+//=====================================================================================
+#define INFO_DB_RELEASE_CHUNK (1u << 20)
+
+// 文本 *.db 的行索引项：第一行出现该 ID 的行偏移
+typedef struct INFO_LINE {
     uint32_t id;
-    char* type;
-    char* content;
-} builtin_info_entry;
+    uint32_t off;
+} INFO_LINE;
 
-static builtin_info_entry* builtin_info_table = NULL;
-static int builtin_info_table_size = 0;
-static char info_base_dir[512] = "examples";
+typedef struct INFO_TABLE {
+    const char*          strings;       // 字符串区（条目中的偏移相对于此）
+    uint32_t             strings_size;  // 已使用的字节数
+    const INFO_DB_ENTRY* entries;       // 第 j 个 ID 的条目（文本来源时物化后才有效）
+    int                  count;         // 不同 ID 的个数
+    const uint32_t*      direct;        // ID -> j + 1（0 为空）；为 NULL 时二分查找
+    uint32_t             direct_size;
+    const uint32_t*      args;          // 各条目的参数，条目中的 args 为下标
+    uint32_t             nargs;
+    int                  mapped;        // 指向编译库映射
+    // 文本来源
+    int                  typed;         // 行含 "TYPE"（builtin）
+    const char*          map;           // 文件映射（表的生命周期内保持）
+    size_t               map_size;
+    INFO_LINE*           lines;         // 行索引，按 ID 排序；编译库时为 NULL
+    uint8_t*             loaded;        // 已物化的 j 的位图
+    char*                arena;         // strings / entries / args 的可写存储
+    INFO_DB_ENTRY*       slots;
+    uint32_t*            arg_slots;
+    uint32_t*            types;         // 已驻留的类型字符串偏移
+    int                  ntypes;
+    int                  types_cap;
+} INFO_TABLE;
+
+static INFO_TABLE builtin_info_table;
+static INFO_TABLE domain_info_table;
+static INFO_TABLE instance_info_table;
 
 /*
  * set_info_base
@@ -65,6 +602,7 @@ static char info_base_dir[512] = "examples";
  * 兼容性：仅处理 POSIX 分隔符 '/'，不对 Windows '\\' 做特殊处理。
  */
 void set_info_base(const char* dir) {
+    info_db_unusable = 0;
     const char* last_slash = strrchr(dir, '/');  // 查找最后一个 '/'，以区分目录与文件名
     if (last_slash) {
         size_t len = last_slash - dir;           // 取最后一个 '/' 之前的目录长度
@@ -77,76 +615,620 @@ void set_info_base(const char* dir) {
     }
 }
 
+// 解析行首的 {0xID，行须以 '{' 开头
+static int info_parse_id(const char* p, const char* e, uint32_t* id) {
+    if (e - p < 4 || p[0] != '{' || p[1] != '0' || p[2] != 'x')
+        return 0;
+    p += 3;
+    while (p < e && (*p == ' ' || *p == '\t'))
+        p++;
+    uint32_t v = 0;
+    const char* digits = p;
+    for (; p < e; p++) {
+        int d = *p >= '0' && *p <= '9' ? *p - '0'
+              : *p >= 'a' && *p <= 'f' ? *p - 'a' + 10
+              : *p >= 'A' && *p <= 'F' ? *p - 'A' + 10 : -1;
+        if (d < 0)
+            break;
+        v = (v << 4) | (uint32_t)d;
+    }
+    *id = v;
+    return p > digits;
+}
+
+// 解析 [*p, e) 开头的一个数（0x 前缀为十六进制），成功时 *p 移到数字之后
+static int info_parse_u32(const char** p, const char* e, uint32_t* v) {
+    const char* q = *p;
+    uint32_t base = 10, x = 0;
+    if (e - q > 2 && q[0] == '0' && (q[1] == 'x' || q[1] == 'X')) {
+        base = 16;
+        q += 2;
+    }
+    const char* digits = q;
+    for (; q < e; q++) {
+        uint32_t d = *q >= '0' && *q <= '9' ? (uint32_t)(*q - '0')
+                   : *q >= 'a' && *q <= 'f' ? (uint32_t)(*q - 'a' + 10)
+                   : *q >= 'A' && *q <= 'F' ? (uint32_t)(*q - 'A' + 10) : 16;
+        if (d >= base)
+            break;
+        x = x * base + d;
+    }
+    if (q == digits)
+        return 0;
+    *v = x;
+    *p = q;
+    return 1;
+}
+
+// 将 [p, p + len) 拷入字符串池并补 '\0'，返回其偏移
+static uint32_t info_arena_put(char* arena, uint32_t* top, const char* p, size_t len) {
+    uint32_t off = *top;
+    memcpy(arena + off, p, len);
+    arena[off + len] = '\0';
+    *top = off + (uint32_t)len + 1;
+    return off;
+}
+
+// 行中是否有条目所需的定界符（typed 时 4 个 '"'，否则 ',' 与其后的 '}'），不满足的行不进入索引
+static int info_line_ok(const char* line, const char* e, int typed) {
+    if (!typed) {
+        const char* c = (const char*)memchr(line, ',', (size_t)(e - line));
+        return c && memchr(c, '}', (size_t)(e - c)) != NULL;
+    }
+    const char* q = line - 1;
+    for (int k = 0; k < 4; k++)
+        if (!(q = (const char*)memchr(q + 1, '"', (size_t)(e - q - 1))))
+            return 0;
+    return 1;
+}
+
+static int info_line_cmp(const void* a, const void* b) {
+    const INFO_LINE* x = (const INFO_LINE*)a;
+    const INFO_LINE* y = (const INFO_LINE*)b;
+    if (x->id != y->id)
+        return x->id < y->id ? -1 : 1;
+    return x->off < y->off ? -1 : x->off > y->off;
+}
+
+/*
+ * info_table_index
+ * 作用：为文本 *.db（builtin_info.db / domain_info.db / instance_info.db）建立按 ID 排序的行索引，不解析条目内容。
+ * 行为：
+ *   - 只读 mmap 整个文件并在表的生命周期内保持映射，逐行只解析行首的 {0xID、检查定界符并记下行偏移；
+ *   - 行按 ID 排序，同一 ID 只保留文件中的第一行；最大 ID 不超过条目数的 2 倍（另加 1024）时建立直接索引；
+ *   - 字符串池、条目与参数区按文件长度预留，只在 info_table_materialize 写入时才占用物理页。
+ * 容错：无法打开文件时打印错误（tag 为 NULL 时静默）并返回，表为空；空文件静默得到空表。
+ */
+static void info_table_index(INFO_TABLE* t, const char* filename, const char* tag, int typed) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s", info_base_dir, filename);
+    memset(t, 0, sizeof(*t));
+    t->typed = typed;
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        if (tag)
+            fprintf(stderr, "[info_db][%s] open failed: %s\n", tag, path);
+        if (fd >= 0)
+            close(fd);
+        return;
+    }
+    if (st.st_size == 0 || (uint64_t)st.st_size >= UINT32_MAX) {
+        close(fd);
+        return;
+    }
+    size_t size = (size_t)st.st_size;
+    const char* map = (const char*)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "[info_db][%s] mmap failed: %s\n", tag ? tag : filename, path);
+        return;
+    }
+    t->map = map;
+    t->map_size = size;
+
+    // 扫描过的前缀按 1MB 交还内核，之后只有物化的行会再次调入
+    INFO_LINE* lines = NULL;
+    int count = 0, sorted = 1;
+    size_t released = 0;
+    for (const char* p = map; p < map + size; ) {
+        if ((size_t)(p - map) - released >= INFO_DB_RELEASE_CHUNK) {
+            madvise((void*)(map + released), INFO_DB_RELEASE_CHUNK, MADV_DONTNEED);
+            released += INFO_DB_RELEASE_CHUNK;
+        }
+        const char* e = (const char*)memchr(p, '\n', (size_t)(map + size - p));
+        if (!e)
+            e = map + size;
+        const char* line = p;
+        p = e + 1;
+        uint32_t id;
+        if (line[0] != '{' || !info_parse_id(line, e, &id) || !info_line_ok(line, e, typed))
+            continue;
+        if ((count & (count - 1)) == 0) {
+            INFO_LINE* grown = (INFO_LINE*)realloc(lines, (size_t)(count ? count * 2 : 64) * sizeof(INFO_LINE));
+            if (!grown)
+                break;
+            lines = grown;
+        }
+        if (count && lines[count - 1].id >= id)
+            sorted = 0;
+        lines[count++] = (INFO_LINE){ id, (uint32_t)(line - map) };
+    }
+    madvise((void*)map, size, MADV_DONTNEED);
+    if (!sorted) {
+        qsort(lines, (size_t)count, sizeof(INFO_LINE), info_line_cmp);
+        int n = 1;
+        for (int i = 1; i < count; i++)
+            if (lines[i].id != lines[n - 1].id)
+                lines[n++] = lines[i];
+        count = n;
+    }
+
+    // 每个字符串至少消耗一个未拷贝的定界符（'"' 或 '}'），每个参数至少占一个数字与一个分隔符
+    t->arena = (char*)malloc(size + 1);
+    t->slots = (INFO_DB_ENTRY*)malloc(((size_t)count + 1) * sizeof(INFO_DB_ENTRY));
+    t->arg_slots = (uint32_t*)malloc((size / 2 + 1) * sizeof(uint32_t));
+    t->loaded = (uint8_t*)calloc((size_t)count / 8 + 1, 1);
+    if (!t->arena || !t->slots || !t->arg_slots || !t->loaded) {
+        fprintf(stderr, "[info_db][%s] out of memory\n", tag ? tag : filename);
+        free(lines);
+        count = 0;
+        lines = NULL;
+    }
+    t->lines = lines;
+    t->count = count;
+    t->strings = t->arena;
+    t->entries = t->slots;
+    t->args = t->arg_slots;
+    if (count && lines[count - 1].id <= 2u * (uint32_t)count + 1024) {
+        uint32_t* direct = (uint32_t*)calloc((size_t)lines[count - 1].id + 1, sizeof(uint32_t));
+        for (int i = 0; direct && i < count; i++)
+            direct[lines[i].id] = (uint32_t)i + 1;
+        if (direct)
+            t->direct_size = lines[count - 1].id + 1;
+        t->direct = direct;
+    }
+}
+
+/*
+ * info_table_materialize
+ * 作用：解析文本表中第 j 个 ID 所在的行，写入条目、字符串池与参数区（每个 ID 只解析一次）。
+ * 行为：
+ *   - typed 时行形如 {0xID, "TYPE", "CONTENT", [ARGS...]}，ARGS 为逗号分隔的数（display 的信号地址），
+ *     类型字符串与已出现的类型比较后复用；否则形如 {0xID, CONTENT}（取第一个 ',' 之后到最后一个 '}' 之前）；
+ *   - 解析失败的行得到没有类型与内容的条目，查询结果与 ID 不存在相同。
+ */
+static void info_table_materialize(INFO_TABLE* t, int j) {
+    const char* line = t->map + t->lines[j].off;
+    const char* e = (const char*)memchr(line, '\n', t->map_size - t->lines[j].off);
+    if (!e)
+        e = t->map + t->map_size;
+    char* arena = t->arena;
+    INFO_DB_ENTRY ent = { t->lines[j].id, INFO_DB_NONE, INFO_DB_NONE, t->nargs, 0 };
+    t->loaded[j / 8] |= (uint8_t)(1u << (j % 8));
+
+    if (t->typed) {
+        const char* ts = (const char*)memchr(line, '"', (size_t)(e - line));
+        const char* te = ts ? (const char*)memchr(ts + 1, '"', (size_t)(e - ts - 1)) : NULL;
+        const char* cs = te ? (const char*)memchr(te + 1, '"', (size_t)(e - te - 1)) : NULL;
+        const char* ce = cs ? (const char*)memchr(cs + 1, '"', (size_t)(e - cs - 1)) : NULL;
+        if (!ce) {
+            t->slots[j] = ent;
+            return;
+        }
+        size_t tlen = (size_t)(te - ts - 1);
+        for (int k = 0; k < t->ntypes && ent.type == INFO_DB_NONE; k++)
+            if (strncmp(arena + t->types[k], ts + 1, tlen) == 0 && arena[t->types[k] + tlen] == '\0')
+                ent.type = t->types[k];
+        if (ent.type == INFO_DB_NONE) {
+            if (t->ntypes == t->types_cap) {
+                uint32_t* grown = (uint32_t*)realloc(t->types, (size_t)(t->types_cap ? t->types_cap * 2 : 8) * sizeof(uint32_t));
+                if (!grown) {
+                    t->slots[j] = ent;
+                    return;
+                }
+                t->types = grown;
+                t->types_cap = t->types_cap ? t->types_cap * 2 : 8;
+            }
+            ent.type = t->types[t->ntypes++] = info_arena_put(arena, &t->strings_size, ts + 1, tlen);
+        }
+        ent.content = info_arena_put(arena, &t->strings_size, cs + 1, (size_t)(ce - cs - 1));
+
+        const char* a = (const char*)memchr(ce + 1, '[', (size_t)(e - ce - 1));
+        for (uint32_t v; a && a < e && *a != ']'; ) {
+            a++;
+            while (a < e && *a == ' ')
+                a++;
+            if (!info_parse_u32(&a, e, &v))
+                break;
+            t->arg_slots[t->nargs++] = v;
+            ent.nargs++;
+            while (a < e && *a == ' ')
+                a++;
+        }
+    } else {
+        const char* cs = (const char*)memchr(line, ',', (size_t)(e - line));
+        const char* ce = e;
+        while (ce > line && *--ce != '}')
+            ;
+        if (cs && *ce == '}') {
+            cs++;
+            while (cs < ce && *cs == ' ')
+                cs++;
+            if (cs <= ce)
+                ent.content = info_arena_put(arena, &t->strings_size, cs, (size_t)(ce - cs));
+        }
+    }
+    t->slots[j] = ent;
+}
+
+/*
+ * info_table_map
+ * 作用：让信息表直接指向编译库中 section 偏移处描述的表（条目均已就绪，无需物化）。
+ * 返回：编译库可用返回1；否则返回0，由调用方回退到文本索引。
+ */
+static int info_table_map(INFO_TABLE* t, size_t section) {
+    const uint8_t* map = info_db_acquire();
+    if (!map)
+        return 0;
+    const INFO_DB_TABLE* d = (const INFO_DB_TABLE*)(map + section);
+    memset(t, 0, sizeof(*t));
+    t->strings = (const char*)(map + d->strings);
+    t->strings_size = d->strings_size;
+    t->entries = (const INFO_DB_ENTRY*)(map + d->entries);
+    t->count = (int)d->count;
+    t->direct = d->direct_size ? (const uint32_t*)(map + d->direct) : NULL;
+    t->direct_size = d->direct_size;
+    t->args = (const uint32_t*)(map + d->args);
+    t->nargs = d->nargs;
+    t->mapped = 1;
+    return 1;
+}
+
+static void info_table_init(INFO_TABLE* t, size_t section, const char* filename, const char* tag, int typed) {
+    if (!info_table_map(t, section))
+        info_table_index(t, filename, tag, typed);
+}
+
+static void info_table_free(INFO_TABLE* t) {
+    if (t->mapped) {
+        info_db_release();
+    } else {
+        if (t->map)
+            munmap((void*)t->map, t->map_size);
+        free(t->lines);
+        free(t->arena);
+        free(t->slots);
+        free(t->arg_slots);
+        free(t->loaded);
+        free(t->types);
+        free((void*)t->direct);
+    }
+    memset(t, 0, sizeof(*t));
+}
+
+// ID -> 第 j 个 ID（文本表为行索引，编译库为条目），不存在时返回 -1
+static int info_table_find(const INFO_TABLE* t, uint32_t id) {
+    if (t->direct) {
+        uint32_t i = id < t->direct_size ? t->direct[id] : 0;
+        return i && i <= (uint32_t)t->count ? (int)i - 1 : -1;
+    }
+    int lo = 0, hi = t->count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if ((t->lines ? t->lines[mid].id : t->entries[mid].id) < id)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo < t->count && (t->lines ? t->lines[lo].id : t->entries[lo].id) == id ? lo : -1;
+}
+
+// 第 j 个 ID 的条目，文本表首次访问时物化
+static const INFO_DB_ENTRY* info_table_at(INFO_TABLE* t, int j) {
+    if (t->lines && !(t->loaded[j / 8] & (1u << (j % 8))))
+        info_table_materialize(t, j);
+    return &t->entries[j];
+}
+
+static const INFO_DB_ENTRY* info_table_get(INFO_TABLE* t, uint32_t id) {
+    int j = info_table_find(t, id);
+    return j < 0 ? NULL : info_table_at(t, j);
+}
+
+// 条目中的字符串偏移 -> 字符串；INFO_DB_NONE 或越界时为 NULL
+static char* info_table_str(const INFO_TABLE* t, uint32_t off) {
+    return off < t->strings_size ? (char*)t->strings + off : NULL;
+}
+
+//=====================================================================================
+//   display 模板：display 条目物化后（通常是加载镜像后预取时）把格式串预编译为段列表，
+//   每段为一段字面文本加一个带类型的参数槽（绑定信号地址与参数名中的位切片）；
+//   send 时按段把字面文本与当前信号值直接写入输出缓冲区，不经 printf 格式解析
+//=====================================================================================
+#define DISPLAY_MAX_ARGS 32
+
+typedef struct DISPLAY_SEG {
+    uint32_t text;      // 参数槽之前的字面文本在字符串区中的偏移
+    uint32_t len;
+    uint32_t addr;      // 参数信号地址
+    char     conv;      // 参数类型 d/h/b/o/c，0 表示只有字面文本
+    uint8_t  lsb;       // 参数名中位切片 [msb:lsb] 的最低位
+    uint8_t  width;     // 切片位宽，0 表示整字（不补前导零）
+} DISPLAY_SEG;
+
+// 第 j 个 builtin ID 的模板：段为 display_segs[first, first + n)，n 为 0 时原样输出 CONTENT
+typedef struct DISPLAY_TMPL {
+    uint32_t first;
+    uint32_t n;
+} DISPLAY_TMPL;
+
+static DISPLAY_SEG*  display_segs = NULL;
+static uint32_t      display_nsegs = 0;
+static uint32_t      display_cap = 0;
+static DISPLAY_TMPL* display_tmpls = NULL;  // 按 builtin 的 ID 个数清零分配，只在编译模板时占用物理页
+static uint8_t*      display_done = NULL;   // 已编译模板的 j 的位图
+static char*        send_line = NULL;      // builtin_send_line 的输出缓冲区
+static size_t       send_line_len = 0;
+static size_t       send_line_cap = 0;
+
+// s[i] 为 '%' 时判断是否为参数转换（可带宽度数字）：返回类型并把 *next 置为转换之后，"%%" 返回 '%'，否则返回0
+static char display_conv(const char* s, uint32_t i, uint32_t len, uint32_t* next) {
+    uint32_t j = i + 1;
+    while (j < len && s[j] >= '0' && s[j] <= '9')
+        j++;
+    if (j >= len)
+        return 0;
+    *next = j + 1;
+    switch (s[j]) {
+        case '%':                               return j == i + 1 ? '%' : 0;
+        case 'd': case 'D':                     return 'd';
+        case 'h': case 'H': case 'x': case 'X':
+        case 's': case 'S':                     return 'h';
+        case 'b': case 'B':                     return 'b';
+        case 'o': case 'O':                     return 'o';
+        case 'c': case 'C':                     return 'c';
+        default:                                return 0;
+    }
+}
+
+static int display_push(DISPLAY_SEG seg) {
+    if (display_nsegs == display_cap) {
+        uint32_t cap = display_cap ? display_cap * 2 : 64;
+        DISPLAY_SEG* grown = (DISPLAY_SEG*)realloc(display_segs, (size_t)cap * sizeof(DISPLAY_SEG));
+        if (!grown)
+            return 0;
+        display_segs = grown;
+        display_cap = cap;
+    }
+    display_segs[display_nsegs++] = seg;
+    return 1;
+}
+
+/*
+ * compile_display
+ * 作用：把一个 display 条目编译为段列表，追加到 display_segs，返回段数。
+ * 行为：
+ *   - CONTENT 形如 "格式串, 参数名..."：格式串中有 n 个转换（%d/%h/%x/%b/%o/%c/%s，%s 按十六进制）
+ *     且条目至少有 n 个信号地址时编译，第 k 个转换绑定第 k 个地址；
+ *   - 最后一个转换之后恰有 n 个 ", 名称" 时视为参数名，从输出中去掉，名称末尾的 [msb:lsb] 或 [b] 作为位切片；
+ *   - 没有转换或地址不足时不编译，send 原样输出 CONTENT。
+ * 示例：
+ *   "top.op[5:5] : %s, top.op[5:5]", [0x1008] => "top.op[5:5] : " + 0x1008 的 bit5（十六进制）
+ */
+static uint32_t compile_display(const INFO_TABLE* t, const INFO_DB_ENTRY* e) {
+    const char* c = info_table_str(t, e->content);
+    if (!c || e->args > t->nargs || e->nargs > t->nargs - e->args)
+        return 0;
+    uint32_t len = (uint32_t)strlen(c), n = 0, last = 0;
+    for (uint32_t i = 0, next; i < len; i++) {
+        char conv = c[i] == '%' ? display_conv(c, i, len, &next) : 0;
+        if (!conv)
+            continue;
+        if (conv != '%') {
+            n++;
+            last = next;
+        }
+        i = next - 1;
+    }
+    if (n == 0 || n > DISPLAY_MAX_ARGS || e->nargs < n)
+        return 0;
+
+    // 从末尾找 n 个 ", 名称"
+    uint32_t name_lo[DISPLAY_MAX_ARGS], name_hi[DISPLAY_MAX_ARGS];
+    uint32_t k = n, hi = len;
+    for (uint32_t p = len; p-- > last && k > 0; ) {
+        if (c[p] == ',' && p + 1 < len && c[p + 1] == ' ') {
+            k--;
+            name_lo[k] = p + 2;
+            name_hi[k] = hi;
+            hi = p;
+        }
+    }
+    int named = k == 0;
+    uint32_t fmt_end = named ? hi : len;
+
+    uint32_t lit = 0, arg = 0, first = display_nsegs;
+    for (uint32_t i = 0, next; i < fmt_end; i++) {
+        char conv = c[i] == '%' ? display_conv(c, i, fmt_end, &next) : 0;
+        if (!conv)
+            continue;
+        DISPLAY_SEG seg = { e->content + lit, i - lit, 0, 0, 0, 0 };
+        if (conv == '%') {
+            seg.len++;
+        } else {
+            seg.conv = conv;
+            seg.addr = t->args[e->args + arg];
+            // 参数名末尾的位切片
+            uint32_t lo = named ? name_lo[arg] : 0, nh = named ? name_hi[arg] : 0;
+            const char* b = named && nh > lo && c[nh - 1] == ']' ? (const char*)memchr(c + lo, '[', nh - lo) : NULL;
+            uint32_t msb, lsb;
+            if (b && (b++, info_parse_u32(&b, c + nh, &msb))) {
+                lsb = msb;
+                if (*b == ':')
+                    b++;
+                if ((b == c + nh - 1 || (info_parse_u32(&b, c + nh, &lsb) && b == c + nh - 1)) && msb >= lsb && msb < 32) {
+                    seg.lsb = (uint8_t)lsb;
+                    seg.width = (uint8_t)(msb - lsb + 1);
+                }
+            }
+            arg++;
+        }
+        if (!display_push(seg)) {
+            display_nsegs = first;
+            return 0;
+        }
+        lit = next;
+        i = next - 1;
+    }
+    if (lit < fmt_end && !display_push((DISPLAY_SEG){ e->content + lit, fmt_end - lit, 0, 0, 0, 0 })) {
+        display_nsegs = first;
+        return 0;
+    }
+    return display_nsegs - first;
+}
+
+// 第 j 个 builtin ID 的模板，首次使用时编译（非 display 条目为空模板）
+static const DISPLAY_TMPL* display_tmpl_at(int j) {
+    static const DISPLAY_TMPL none = { 0, 0 };
+    if (!display_tmpls)
+        return &none;
+    if (!(display_done[j / 8] & (1u << (j % 8)))) {
+        const INFO_TABLE* t = &builtin_info_table;
+        const INFO_DB_ENTRY* e = info_table_at(&builtin_info_table, j);
+        const char* type = info_table_str(t, e->type);
+        display_tmpls[j].first = display_nsegs;
+        display_tmpls[j].n = type && strcmp(type, "display") == 0 ? compile_display(t, e) : 0;
+        display_done[j / 8] |= (uint8_t)(1u << (j % 8));
+    }
+    return &display_tmpls[j];
+}
+
+static void free_display_templates() {
+    free(display_segs);
+    free(display_tmpls);
+    free(display_done);
+    free(send_line);
+    display_segs = NULL;
+    display_nsegs = display_cap = 0;
+    display_tmpls = NULL;
+    display_done = NULL;
+    send_line = NULL;
+    send_line_len = send_line_cap = 0;
+}
+
+static void send_put(const char* s, size_t n) {
+    if (send_line_len + n > send_line_cap) {
+        size_t cap = send_line_cap ? send_line_cap : 256;
+        while (cap < send_line_len + n)
+            cap *= 2;
+        char* grown = (char*)realloc(send_line, cap);
+        if (!grown)
+            return;
+        send_line = grown;
+        send_line_cap = cap;
+    }
+    memcpy(send_line + send_line_len, s, n);
+    send_line_len += n;
+}
+
+// 按 base（2/8/10/16）写出 v，至少 digits 位（前导零）
+static void send_put_u32(uint32_t v, uint32_t base, uint32_t digits) {
+    char tmp[32];
+    uint32_t n = 0;
+    do {
+        tmp[sizeof(tmp) - ++n] = "0123456789abcdef"[v % base];
+        v /= base;
+    } while (v || n < digits);
+    send_put(tmp + sizeof(tmp) - n, n);
+}
+
+static void send_put_str(const char* s) {
+    send_put(s, strlen(s));
+}
+
+/*
+ * builtin_send_line
+ * 作用：生成 send 指令输出的一行文本（含颜色与换行），返回内部缓冲区，下次调用前有效。
+ * 行为：
+ *   - 有 builtin 条目时为 "TYPE ID: 内容"：display 模板按段渲染，参数槽取 get_signal_value 的当前值
+ *     （有切片时移位截取并按位宽补前导零），其余条目原样输出 CONTENT；
+ *   - 没有条目时为 "send func:0xF db_id:ID (no builtin info)"。
+ * 示例：
+ *   builtin_send_line(0, 0x0, &n) => "\x1b[1;34mdisplay 0: top.op[5:5] : 0\x1b[0m\n"（0x1008 = 0x600f 时）
+ */
+const char* builtin_send_line(uint32_t id, uint8_t func, size_t* len) {
+    INFO_TABLE* t = &builtin_info_table;
+    int j = info_table_find(t, id);
+    const INFO_DB_ENTRY* e = j >= 0 ? info_table_at(t, j) : NULL;
+    const char* type = e ? info_table_str(t, e->type) : NULL;
+    send_line_len = 0;
+    send_put_str(ANSI_BOLD_BLUE);
+    if (type) {
+        send_put_str(type);
+        send_put(" ", 1);
+        send_put_u32(id, 10, 1);
+        send_put(": ", 2);
+        const DISPLAY_TMPL* tmpl = display_tmpl_at(j);
+        uint32_t s = tmpl->first, end = tmpl->first + tmpl->n;
+        if (s == end) {
+            const char* content = info_table_str(t, e->content);
+            send_put_str(content ? content : "");
+        }
+        for (; s < end; s++) {
+            const DISPLAY_SEG* seg = &display_segs[s];
+            send_put(t->strings + seg->text, seg->len);
+            if (!seg->conv)
+                continue;
+            uint32_t v = get_signal_value(seg->addr) >> seg->lsb;
+            if (seg->width && seg->width < 32)
+                v &= (1u << seg->width) - 1;
+            switch (seg->conv) {
+                case 'd': send_put_u32(v, 10, 1); break;
+                case 'h': send_put_u32(v, 16, (seg->width + 3) / 4); break;
+                case 'b': send_put_u32(v, 2, seg->width); break;
+                case 'o': send_put_u32(v, 8, (seg->width + 2) / 3); break;
+                case 'c': { char ch = (char)v; send_put(&ch, 1); break; }
+            }
+        }
+    } else {
+        send_put_str("send func:0x");
+        send_put_u32(func, 16, 1);
+        send_put(" db_id:", 7);
+        send_put_u32(id, 10, 1);
+        send_put(" (no builtin info)", 18);
+    }
+    send_put_str(ANSI_RESET);
+    send_put("\n", 1);
+    *len = send_line_len;
+    return send_line;
+}
+
 /*
  * init_builtin_info_table
  * 作用：加载 builtin 信息表，包含 display/exec/force/release/dump/get/set/load 等统一操作。
- * 输入：无（使用全局 info_base_dir 拼接 "builtin_info.db"）。
+ * 输入：无（使用全局 info_base_dir 下的 info.tdb，或拼接 "builtin_info.db"）。
  * 文件格式：每行形如 {0xID, "TYPE", "CONTENT", [ARGS...]}
  */
 void init_builtin_info_table() {
-    char path[1024];
-    snprintf(path, sizeof(path), "%s/builtin_info.db", info_base_dir);
-    FILE* file = fopen(path, "r");
-    if (!file) {
-        fprintf(stderr, "[info_db][builtin] open failed: %s\n", path);
-        return;
+    info_table_init(&builtin_info_table, offsetof(INFO_DB_HEADER, builtin), "builtin_info.db", "builtin", 1);
+    display_tmpls = (DISPLAY_TMPL*)calloc((size_t)builtin_info_table.count + 1, sizeof(DISPLAY_TMPL));
+    display_done = (uint8_t*)calloc((size_t)builtin_info_table.count / 8 + 1, 1);
+    if (!display_tmpls || !display_done) {
+        free(display_tmpls);
+        free(display_done);
+        display_tmpls = NULL;
+        display_done = NULL;
     }
-    int lines = 0; char ch;
-    while(!feof(file)) { ch = fgetc(file); if (ch == '\n') lines++; }
-    rewind(file);
-    builtin_info_table = (builtin_info_entry*)malloc(lines * sizeof(builtin_info_entry));
-    if (!builtin_info_table) { fclose(file); return; }
-    char line[1024]; int i = 0;
-    while (fgets(line, sizeof(line), file) && i < lines) {
-        if (line[0] != '{') continue;
-        uint32_t id; 
-        if (sscanf(line, "{0x%x,", &id) != 1) continue;
-        
-        // 提取 TYPE
-        char* type_start = strchr(line, '"');
-        if (!type_start) continue;
-        char* type_end = strchr(type_start + 1, '"');
-        if (!type_end) continue;
-        int type_len = type_end - type_start - 1;
-        char* type = (char*)malloc(type_len + 1);
-        if (!type) continue;
-        strncpy(type, type_start + 1, type_len);
-        type[type_len] = '\0';
-
-        // 提取 CONTENT
-        char* content_start = strchr(type_end + 1, '"');
-        if (!content_start) { free(type); continue; }
-        char* content_end = strchr(content_start + 1, '"');
-        if (!content_end) { free(type); continue; }
-        int content_len = content_end - content_start - 1;
-        char* content = (char*)malloc(content_len + 1);
-        if (!content) { free(type); continue; }
-        strncpy(content, content_start + 1, content_len);
-        content[content_len] = '\0';
-
-        builtin_info_table[i].id = id;
-        builtin_info_table[i].type = type;
-        builtin_info_table[i].content = content;
-        i++;
-    }
-    builtin_info_table_size = i;
-    fclose(file);
 }
 
 /*
  * free_builtin_info_table
- * 作用：释放 builtin 信息表的动态内存。
+ * 作用：释放 builtin 信息表的字符串池、索引与 display 模板（编译库时解除引用）。
  */
 void free_builtin_info_table() {
-    if (builtin_info_table) {
-        for (int i = 0; i < builtin_info_table_size; i++) {
-            if (builtin_info_table[i].type) free(builtin_info_table[i].type);
-            if (builtin_info_table[i].content) free(builtin_info_table[i].content);
-        }
-        free(builtin_info_table);
-        builtin_info_table = NULL;
-        builtin_info_table_size = 0;
-    }
+    free_display_templates();
+    info_table_free(&builtin_info_table);
 }
 
 /*
@@ -154,10 +1236,8 @@ void free_builtin_info_table() {
  * 作用：通过 ID 获取完整的展示字符串。
  */
 char* get_builtin_info(uint32_t id) {
-    for (int i = 0; i < builtin_info_table_size; i++) {
-        if (builtin_info_table[i].id == id) return builtin_info_table[i].content;
-    }
-    return NULL;
+    const INFO_DB_ENTRY* e = info_table_get(&builtin_info_table, id);
+    return e ? info_table_str(&builtin_info_table, e->content) : NULL;
 }
 
 /*
@@ -165,115 +1245,199 @@ char* get_builtin_info(uint32_t id) {
  * 作用：通过 ID 获取指令类型（display/exec等）。
  */
 char* get_builtin_type(uint32_t id) {
-    for (int i = 0; i < builtin_info_table_size; i++) {
-        if (builtin_info_table[i].id == id) return builtin_info_table[i].type;
-    }
-    return NULL;
+    const INFO_DB_ENTRY* e = info_table_get(&builtin_info_table, id);
+    return e ? info_table_str(&builtin_info_table, e->type) : NULL;
 }
 
-typedef struct simple_entry {
-    uint32_t id;
-    char* content;
-} simple_entry;
+/*
+ * prefetch_builtin_info
+ * 作用：物化 id 对应的 builtin 条目并编译其 display 模板，send 执行时不再解析；id 不存在时无操作。
+ */
+void prefetch_builtin_info(uint32_t id) {
+    int j = info_table_find(&builtin_info_table, id);
+    if (j >= 0)
+        display_tmpl_at(j);
+}
 
-static simple_entry* domain_info_table = NULL; static int domain_info_table_size = 0;
+void prefetch_domain_info(uint32_t id) { info_table_get(&domain_info_table, id); }
 
-/*
-* 作用：通用加载器，读取 exec/domain/timer 等简单信息表。
-* 文件格式：每行形如 {0xID,CONTENT...}
-* 行为：统计行数分配内存，逐行解析 ID 与 CONTENT 字段，填充 simple_entry 数组。
-* 容错：无法打开文件直接返回；单行解析失败跳过；内存分配失败则终止并释放文件句柄。
-*/
-static void init_simple_table(const char* filename, simple_entry** table, int* table_size) {
-    char path[1024]; snprintf(path, sizeof(path), "%s/%s", info_base_dir, filename);
-    FILE* file = fopen(path, "r"); if (!file) { fprintf(stderr, "[info_db][%s] open failed: %s\n", filename, path); return; }
-    int lines = 0; char ch; while(!feof(file)) { ch = fgetc(file); if (ch == '\n') lines++; }
-    rewind(file);
-    *table = (simple_entry*)malloc(lines * sizeof(simple_entry)); if (!*table) { fclose(file); return; }
-    char line[1024]; int i = 0;
-    while (fgets(line, sizeof(line), file) && i < lines) {
-        if (line[0] != '{') continue;
-        uint32_t id; if (sscanf(line, "{0x%x,", &id) != 1) continue;
-        char* start = strchr(line, ','); if (!start) continue; start++; while (*start == ' ') start++;
-        char* end = strrchr(line, '}'); if (!end) continue; *end = '\0';
-        size_t len = strlen(start); char* content = (char*)malloc(len + 1); if (!content) continue; strcpy(content, start);
-        (*table)[i].id = id; (*table)[i].content = content; i++;
-    }
-    *table_size = i; fclose(file);
+void init_domain_info_table() { info_table_init(&domain_info_table, offsetof(INFO_DB_HEADER, domain), "domain_info.db", "domain_info.db", 0); }
+void free_domain_info_table() { info_table_free(&domain_info_table); }
+char* get_domain_info(uint32_t id) { const INFO_DB_ENTRY* e = info_table_get(&domain_info_table, id); return e ? info_table_str(&domain_info_table, e->content) : NULL; }
+
+void init_instance_info_table() { info_table_init(&instance_info_table, offsetof(INFO_DB_HEADER, instance), "instance_info.db", NULL, 0); }
+void free_instance_info_table() { info_table_free(&instance_info_table); }
+char* get_instance_info(uint32_t id) { const INFO_DB_ENTRY* e = info_table_get(&instance_info_table, id); return e ? info_table_str(&instance_info_table, e->content) : NULL; }
+
+// 追加 [p, p + len) 到编译库映像的 *off 处，*off 按 4 字节对齐后前进；image 为 NULL 时只计算布局
+static uint32_t info_db_emit(uint8_t* image, uint32_t* off, const void* p, size_t len) {
+    uint32_t at = *off;
+    if (image && len)
+        memcpy(image + at, p, len);
+    *off = (at + (uint32_t)len + 3) & ~3u;
+    return at;
 }
 
-/*
- * free_simple_table
- * 作用：释放 simple_entry 表（exec/domain/timer）。
- * 行为：逐项释放 content，清空指针并重置大小。
- */
-static void free_simple_table(simple_entry** table, int* table_size) {
-    if (*table) {
-        for (int i = 0; i < *table_size; i++) { if ((*table)[i].content) free((*table)[i].content); }
-        free(*table);
-        *table = NULL;
-        *table_size = 0;
-    }
+static void info_db_emit_table(uint8_t* image, uint32_t* off, INFO_DB_TABLE* d, const INFO_TABLE* t) {
+    d->count = (uint32_t)t->count;
+    d->entries = info_db_emit(image, off, t->entries, (size_t)t->count * sizeof(INFO_DB_ENTRY));
+    d->direct_size = t->direct ? t->direct_size : 0;
+    d->direct = info_db_emit(image, off, t->direct, (size_t)d->direct_size * sizeof(uint32_t));
+    d->strings_size = t->strings_size;
+    d->strings = info_db_emit(image, off, t->strings, t->strings_size);
+    d->nargs = t->nargs;
+    d->args = info_db_emit(image, off, t->args, (size_t)t->nargs * sizeof(uint32_t));
 }
 
 /*
- * get_simple_info
- * 作用：在给定 simple_entry 表中按 ID 查找文本内容。
- * 返回：找到返回指针；未找到返回 NULL。生命周期随表而定。
+ * info_db_compile
+ * 作用：解析 DB 目录下的文本 builtin/domain/instance/signal_split 表并写出编译库 path。
+ * 行为：
+ *   - 始终从文本解析（不读取已有的编译库），全部条目按 ID 顺序物化；
+ *   - 先按空映像计算布局，再一次性填充并写出；拆分信号按名称排序，名称集中放在 split_strings。
+ *   - 写到同目录的临时文件后 rename 替换 path，并发运行中已映射旧文件的程序不受影响。
+ * 返回：成功返回1，失败打印错误并返回0。
+ * 示例：
+ *   set_info_base("examples/signal_action/"); info_db_compile("examples/signal_action/info.tdb") => 1
  */
-static char* get_simple_info(uint32_t id, simple_entry* table, int table_size) {
-    for (int i = 0; i < table_size; i++) if (table[i].id == id) return table[i].content; return NULL;
-}
+int info_db_compile(const char* path) {
+    INFO_TABLE builtin, domain, instance;
+    info_table_index(&builtin, "builtin_info.db", "builtin", 1);
+    info_table_index(&domain, "domain_info.db", "domain_info.db", 0);
+    info_table_index(&instance, "instance_info.db", NULL, 0);
+    for (int j = 0; j < builtin.count || j < domain.count || j < instance.count; j++) {
+        if (j < builtin.count)
+            info_table_at(&builtin, j);
+        if (j < domain.count)
+            info_table_at(&domain, j);
+        if (j < instance.count)
+            info_table_at(&instance, j);
+    }
+    load_signal_splits_text();
 
-void init_domain_info_table() { init_simple_table("domain_info.db", &domain_info_table, &domain_info_table_size); }
-void free_domain_info_table() { free_simple_table(&domain_info_table, &domain_info_table_size); }
-char* get_domain_info(uint32_t id) { return get_simple_info(id, domain_info_table, domain_info_table_size); }
+    INFO_DB_HEADER h;
+    uint8_t* image = NULL;
+    uint32_t size = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        memset(&h, 0, sizeof(h));
+        memcpy(h.magic, INFO_DB_MAGIC, sizeof(h.magic));
+        h.version = INFO_DB_VERSION;
+        uint32_t off = 0;
+        info_db_emit(NULL, &off, NULL, sizeof(h));
+        info_db_emit_table(image, &off, &h.builtin, &builtin);
+        info_db_emit_table(image, &off, &h.domain, &domain);
+        info_db_emit_table(image, &off, &h.instance, &instance);
+
+        h.nsplits = (uint32_t)signal_split_count;
+        h.splits = info_db_emit(NULL, &off, NULL, (size_t)h.nsplits * sizeof(INFO_DB_SPLIT));
+        uint32_t names = 0;
+        for (int i = 0; i < signal_split_count; i++) {
+            const SIGNAL_SPLIT* sig = &signal_splits[i];
+            INFO_DB_SPLIT d = { names, sig->addr, sig->width, sig->word_bytes, sig->nwords, 0 };
+            d.words = info_db_emit(image, &off, sig->words, (size_t)sig->nwords * sizeof(uint32_t));
+            names += (uint32_t)strlen(sig->name) + 1;
+            if (image)
+                memcpy(image + h.splits + (size_t)i * sizeof(INFO_DB_SPLIT), &d, sizeof(d));
+        }
+        h.split_strings_size = names;
+        h.split_strings = info_db_emit(NULL, &off, NULL, names);
+        for (int i = 0, n = 0; image && i < signal_split_count; i++) {
+            size_t len = strlen(signal_splits[i].name) + 1;
+            memcpy(image + h.split_strings + n, signal_splits[i].name, len);
+            n += (int)len;
+        }
+        h.size = off;
+        if (image)
+            memcpy(image, &h, sizeof(h));
+        else if (!(image = (uint8_t*)calloc(1, (size = off))))
+            break;
+    }
+
+    // 先写同目录的临时文件再改名替换：正在运行的程序仍映射着旧文件，不会看到被截断的内容
+    int ok = 0;
+    char tmp[1100];
+    int tmp_len = snprintf(tmp, sizeof(tmp), "%s.%ld", path, (long)getpid());
+    FILE* out = image && tmp_len < (int)sizeof(tmp) ? fopen(tmp, "wb") : NULL;
+    if (!image)
+        fprintf(stderr, "[info_db][compile] out of memory\n");
+    else if (tmp_len >= (int)sizeof(tmp))
+        fprintf(stderr, "[info_db][compile] path too long: %s\n", path);
+    else if (!out)
+        fprintf(stderr, "[info_db][compile] open failed: %s\n", tmp);
+    else if (fwrite(image, 1, size, out) != size)
+        fprintf(stderr, "[info_db][compile] write failed: %s\n", tmp);
+    else
+        ok = 1;
+    if (out && fclose(out) != 0 && ok) {
+        fprintf(stderr, "[info_db][compile] write failed: %s\n", tmp);
+        ok = 0;
+    }
+    if (ok && rename(tmp, path) != 0) {
+        fprintf(stderr, "[info_db][compile] rename failed: %s -> %s\n", tmp, path);
+        ok = 0;
+    }
+    if (out && !ok)
+        unlink(tmp);
+    if (ok)
+        printf("%s: BUILTIN:%d DOMAIN:%d INSTANCE:%d SIGNAL:%d, %u bytes\n", path,
+               builtin.count, domain.count, instance.count, signal_split_count, size);
+    free(image);
+    free_signal_splits();
+    info_table_free(&builtin);
+    info_table_free(&domain);
+    info_table_free(&instance);
+    return ok;
+}
 
 /*
- * 作用：模拟定时器计数并跳转。
+ * 作用：处理本条指令 tick 时到期的定时器并跳转。
  * 行为：
- *   - 对每个定时器：
- *     - 若使能，增加计数器；
- *     - 若超过阈值，禁用并重置计数器；
- *     - 若有目标 PC，跳转执行。
+ *   - 从定时器调度中依次取出到期的定时器（按 id 从小到大），计数清零并排入下一次到期；
+ *   - 若有目标 PC，跳转执行（同时到期时最后一个生效）。
+ * 返回：发生跳转返回1，否则返回0。
  */
-void timer_tick_and_jump(CPU* cpu) {
-    for (int id = 0; id < 2; ++id) {
-        if (cpu->timer_enabled[id]) {
-            uint64_t c = cpu->timer[id] + 1;
-            cpu->timer[id] = c;
-            if (c >= cpu->timer_threshold[id]) {
-                cpu->timer[id] = 0;
-                if (cpu->timer_target_pc[id]) {
-                    printf("%sTimer %d reached %" PRIu64 ", jump -> %#.8x%s\n", ANSI_BOLD_GREEN, id, cpu->timer_threshold[id], cpu->timer_target_pc[id], ANSI_RESET);
-                    cpu->pc = cpu->timer_target_pc[id];
-                } else {
-                    printf("%s[cpu][timer] threshold reached (id=%d) but no target%s\n", ANSI_BOLD_RED, id, ANSI_RESET);
-                }
-            }
+int timer_tick_and_jump(CPU* cpu) {
+    int jumped = 0;
+    for (int id; (id = timer_sched_pop(&cpu->timers, cpu->inst_retired)) >= 0; ) {
+        const TIMER* t = &cpu->timers.timers[id];
+        if (t->target_pc) {
+            if (LOG_ENABLED(LOG_SUMMARY))
+                log_printf("%sTimer %d reached %" PRIu64 ", jump -> %#.8x%s\n", ANSI_BOLD_GREEN, id, t->threshold, t->target_pc, ANSI_RESET);
+            cpu->pc = t->target_pc;
+            jumped = 1;
+        } else if (LOG_ENABLED(LOG_SUMMARY)) {
+            log_printf("%s[cpu][timer] threshold reached (id=%d) but no target%s\n", ANSI_BOLD_RED, id, ANSI_RESET);
         }
     }
+    return jumped;
 }
 
 /*
  * info_db_init_all
- * 作用：统一初始化所有信息表，加载 display/exec/domain/timer 四类 DB，便于后续查询与输出。
+ * 作用：统一初始化所有信息表，加载 builtin/domain 信息表与信号索引，便于后续查询与输出。
  * 输出：打印各表的加载数量，便于排查缺失文件或解析异常。
  */
 void info_db_init_all(CPU* cpu) {
+    (void)cpu;
     // 初始化 builtin 信息表
     init_builtin_info_table();
 
-    // 初始化域信息表
+    // 初始化域信息表与实例信息表
     init_domain_info_table();
+    init_instance_info_table();
+
+    // 初始化信号索引
+    init_signal_index();
 
     // 打印数据库加载信息
+    if (!LOG_ENABLED(LOG_SUMMARY))
+        return;
     print_color(ANSI_BOLD);
-    printf("[DB INFO]:\n");
+    log_printf("[DB INFO]:\n");
     print_color(ANSI_RESET);
     print_color(ANSI_BOLD_WHITE);
-    printf("   BUILTIN:%d DOMAIN:%d\n", 
-           builtin_info_table_size,
-           domain_info_table_size);
+    log_printf("   BUILTIN:%d DOMAIN:%d\n", 
+           builtin_info_table.count,
+           domain_info_table.count);
     print_color(ANSI_RESET);
 }
@@ -0,0 +1,501 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include "../include/cpu.h"
+#include "../include/jit.h"
+#include "../include/color.h"
+#include "../include/log.h"
+
+#if defined(__x86_64__) && defined(__linux__)
+#include <sys/mman.h>
+#define TSL_JIT_HOST 1
+#endif
+
+#ifdef TSL_JIT_HOST
+
+// 单条指令生成代码的上限（字节），用于编译前检查代码区剩余空间
+#define JIT_MAX_INST_CODE   96
+// 每块固定部分（入口、链接入口、采样、出口）生成代码的上限（字节）
+#define JIT_MAX_BLOCK_CODE  512
+
+// 生成代码时的写指针
+typedef struct JIT_EMIT {
+    uint8_t* p;
+} JitEmit;
+
+static void emit8(JitEmit* e, uint8_t v)   { *e->p++ = v; }
+static void emit32(JitEmit* e, uint32_t v) { memcpy(e->p, &v, 4); e->p += 4; }
+static void emit64(JitEmit* e, uint64_t v) { memcpy(e->p, &v, 8); e->p += 8; }
+
+// 主机寄存器编号（ModRM reg 字段）
+enum { EAX = 0, ECX = 1, EDX = 2, ESI = 6, EDI = 7 };
+
+// 条件跳转（0F 8x rel32）的条件码
+enum { JB = 0x82, JAE = 0x83, JE = 0x84, JNE = 0x85 };
+
+// rbx 固定保存 CPU*，以下偏移均相对 rbx
+#define OFF_REG(i)      ((uint32_t)(offsetof(CPU, regs) + (i) * sizeof(uint32_t)))
+#define OFF_PC          ((uint32_t)offsetof(CPU, pc))
+#define OFF_RET         ((uint32_t)offsetof(CPU, ret_reg))
+#define OFF_RETIRED     ((uint32_t)offsetof(CPU, inst_retired))
+#define OFF_GEN         ((uint32_t)offsetof(CPU, icache.generation))
+#define OFF_TIMER_NEXT  ((uint32_t)offsetof(CPU, timers.next))
+#define OFF_BUDGET      ((uint32_t)offsetof(CPU, jit.budget))
+#define OFF_LAST        ((uint32_t)offsetof(CPU, jit.last))
+#define OFF_IDLE_ARMED  ((uint32_t)offsetof(CPU, idle.armed))
+#define OFF_IDLE_COOL   ((uint32_t)offsetof(CPU, idle.cooldown))
+#define OFF_SIG_CUR     ((uint32_t)offsetof(CPU, sig.cur))
+#define OFF_SIG_PREV    ((uint32_t)offsetof(CPU, sig.prev))
+#define OFF_SIG_TIME    ((uint32_t)offsetof(CPU, sig.time))
+#define OFF_STIM_EN     ((uint32_t)offsetof(CPU, stim.enabled))
+#define OFF_STIM_NEXT   ((uint32_t)offsetof(CPU, stim.next_time))
+
+// 64 位 op r64, [rbx+disp32]（mov 8B / store 89 / cmp 3B）
+static void emit_mem64(JitEmit* e, uint8_t opc, int r, uint32_t disp) {
+    emit8(e, 0x48); emit8(e, opc); emit8(e, 0x83 | (r << 3)); emit32(e, disp);
+}
+
+// jcc rel32 / jmp rel32，返回待回填的位移位置
+static uint8_t* emit_jcc(JitEmit* e, uint8_t cc) {
+    emit8(e, 0x0F); emit8(e, cc);
+    uint8_t* at = e->p;
+    emit32(e, 0);
+    return at;
+}
+
+static uint8_t* emit_jmp(JitEmit* e) {
+    emit8(e, 0xE9);
+    uint8_t* at = e->p;
+    emit32(e, 0);
+    return at;
+}
+
+static void patch_rel32(uint8_t* at, const uint8_t* target) {
+    int32_t rel = (int32_t)(target - (at + 4));
+    memcpy(at, &rel, 4);
+}
+
+// mov r32, [rbx+disp32]
+static void emit_load(JitEmit* e, int r, uint32_t disp) {
+    emit8(e, 0x8B); emit8(e, 0x83 | (r << 3)); emit32(e, disp);
+}
+
+// mov [rbx+disp32], r32
+static void emit_store(JitEmit* e, int r, uint32_t disp) {
+    emit8(e, 0x89); emit8(e, 0x83 | (r << 3)); emit32(e, disp);
+}
+
+// mov dword [rbx+disp32], imm32（固定 10 字节，条件跳转据此计算跳过长度）
+static void emit_store_imm(JitEmit* e, uint32_t disp, uint32_t imm) {
+    emit8(e, 0xC7); emit8(e, 0x83); emit32(e, disp); emit32(e, imm);
+}
+
+// eax = (eax != 0) / (eax == 0) 等：setcc al; movzx eax, al
+static void emit_setcc(JitEmit* e, uint8_t cc) {
+    emit8(e, 0x0F); emit8(e, cc); emit8(e, 0xC0);
+    emit8(e, 0x0F); emit8(e, 0xB6); emit8(e, 0xC0);
+}
+
+/*
+ * jit_covers
+ * 作用：判断指令能否编译为本机代码。
+ * 行为：纯寄存器运算与跳转可编译；send/domain_set/load/trigger/timer_set 及非法编码
+ *       有输出或副作用，边沿类（edge_detect、jmpc pos/neg）读按周期采样的信号存储，
+ *       均作为退出点回到解释器执行。
+ */
+static int jit_covers(const DecodedInst* d) {
+    switch (d->op) {
+        case INST_OP_MOV: case INST_OP_MOVI:
+        case INST_OP_JMP: case INST_OP_BL: case INST_OP_RET:
+        case INST_OP_JMPC_EQ: case INST_OP_JMPC_NE: case INST_OP_JMPC_GT:
+        case INST_OP_JMPC_LT: case INST_OP_JMPC_GE: case INST_OP_JMPC_LE:
+        case INST_OP_ARITH_AND: case INST_OP_ARITH_OR: case INST_OP_ARITH_XOR:
+        case INST_OP_ARITH_REDU_AND: case INST_OP_ARITH_REDU_OR: case INST_OP_ARITH_REDU_XOR:
+        case INST_OP_ARITH_CONCAT: case INST_OP_ARITH_ISUNKNOW:
+        case INST_OP_ARITH_ADD: case INST_OP_ARITH_SUB:
+            return 1;
+        case INST_OP_BIT_SLICE:
+            return d->lo <= d->hi;  // start > end 由解释器报错
+        default:
+            return 0;
+    }
+}
+
+/*
+ * emit_inst
+ * 作用：生成一条指令的本机代码，语义与对应 exec_* 一致。
+ * 行为：
+ *   - 先写 PC 为下一条指令地址，跳转类再按条件覆盖为目标地址；
+ *   - trace 时之后调用 cpu_trace_retired 打印反汇编与寄存器，保持与解释器相同的输出。
+ */
+static void emit_inst(JitEmit* e, const DecodedInst* d, uint32_t pc, int trace) {
+    static const uint8_t arith_op[] = { 0x21, 0x09, 0x31 };        // and / or / xor eax, ecx
+    // 条件不满足时跳过目标地址写入：EQ->jne NE->je GT->jbe LT->jae GE->jb LE->ja
+    static const uint8_t jmpc_skip[] = { 0x75, 0x74, 0x76, 0x73, 0x72, 0x77 };
+    uint32_t next = pc + d->length;
+    uint32_t target = next + (uint32_t)d->offset;
+
+    emit_store_imm(e, OFF_PC, next);
+
+    switch (d->op) {
+        case INST_OP_MOV:
+            emit_load(e, EAX, OFF_REG(d->rs1));
+            emit_store(e, EAX, OFF_REG(d->rd));
+            break;
+        case INST_OP_MOVI:
+            emit_store_imm(e, OFF_REG(d->rd), d->imm);
+            break;
+        case INST_OP_JMP:
+            emit_store_imm(e, OFF_PC, target);
+            break;
+        case INST_OP_BL:
+            emit_store_imm(e, OFF_RET, next);
+            emit_store_imm(e, OFF_PC, target);
+            break;
+        case INST_OP_RET:
+            emit_load(e, EAX, OFF_RET);
+            emit_store(e, EAX, OFF_PC);
+            emit_store_imm(e, OFF_RET, 0);
+            break;
+        case INST_OP_JMPC_EQ: case INST_OP_JMPC_NE: case INST_OP_JMPC_GT:
+        case INST_OP_JMPC_LT: case INST_OP_JMPC_GE: case INST_OP_JMPC_LE:
+            emit_load(e, EAX, OFF_REG(d->rs1));
+            emit8(e, 0x3B); emit8(e, 0x83); emit32(e, OFF_REG(d->rs2));    // cmp eax, [rs2]
+            emit8(e, jmpc_skip[d->op - INST_OP_JMPC_EQ]); emit8(e, 10);
+            emit_store_imm(e, OFF_PC, target);
+            break;
+        case INST_OP_ARITH_AND: case INST_OP_ARITH_OR: case INST_OP_ARITH_XOR:
+        case INST_OP_ARITH_ADD: case INST_OP_ARITH_SUB:
+            emit_load(e, EAX, OFF_REG(d->rs1));
+            emit_load(e, ECX, OFF_REG(d->rs2));
+            if (d->op == INST_OP_ARITH_ADD)      emit8(e, 0x01);
+            else if (d->op == INST_OP_ARITH_SUB) emit8(e, 0x29);
+            else                                 emit8(e, arith_op[d->op - INST_OP_ARITH_AND]);
+            emit8(e, 0xC8);
+            emit_store(e, EAX, OFF_REG(d->rd));
+            break;
+        case INST_OP_ARITH_REDU_AND:
+            emit_load(e, EAX, OFF_REG(d->rs1));
+            emit8(e, 0x83); emit8(e, 0xF8); emit8(e, 0xFF);                 // cmp eax, -1
+            emit_setcc(e, 0x94);                                            // sete
+            emit_store(e, EAX, OFF_REG(d->rd));
+            break;
+        case INST_OP_ARITH_REDU_OR:
+            emit_load(e, EAX, OFF_REG(d->rs1));
+            emit8(e, 0x85); emit8(e, 0xC0);                                 // test eax, eax
+            emit_setcc(e, 0x95);                                            // setne
+            emit_store(e, EAX, OFF_REG(d->rd));
+            break;
+        case INST_OP_ARITH_REDU_XOR:
+            emit_load(e, EAX, OFF_REG(d->rs1));
+            emit8(e, 0x89); emit8(e, 0xC1);                                 // mov ecx, eax
+            emit8(e, 0xC1); emit8(e, 0xE9); emit8(e, 16);                   // shr ecx, 16
+            emit8(e, 0x31); emit8(e, 0xC8);                                 // xor eax, ecx
+            emit8(e, 0x30); emit8(e, 0xE0);                                 // xor al, ah
+            emit_setcc(e, 0x9B);                                            // setnp：奇数个1
+            emit_store(e, EAX, OFF_REG(d->rd));
+            break;
+        case INST_OP_ARITH_CONCAT:
+            emit_load(e, EAX, OFF_REG(d->rs1));
+            emit_load(e, ECX, OFF_REG(d->rs2));
+            emit8(e, 0xC1); emit8(e, 0xE0); emit8(e, 16);                   // shl eax, 16
+            emit8(e, 0x0F); emit8(e, 0xB7); emit8(e, 0xC9);                 // movzx ecx, cx
+            emit8(e, 0x09); emit8(e, 0xC8);                                 // or eax, ecx
+            emit_store(e, EAX, OFF_REG(d->rd));
+            break;
+        case INST_OP_ARITH_ISUNKNOW:
+            emit_store_imm(e, OFF_REG(d->rd), 1);
+            break;
+        default: { // BIT_SLICE
+            uint32_t mask = ((1U << (d->hi - d->lo + 1)) - 1);
+            emit_load(e, EAX, OFF_REG(d->rs1));
+            emit8(e, 0xC1); emit8(e, 0xE8); emit8(e, d->lo);                // shr eax, lo
+            emit8(e, 0x25); emit32(e, mask);                                // and eax, mask
+            emit_store(e, EAX, OFF_REG(d->rd));
+            break;
+        }
+    }
+
+    if (!trace)
+        return;
+
+    // cpu_trace_retired(cpu, d, pc)
+    emit8(e, 0x48); emit8(e, 0x89); emit8(e, 0xDF);                         // mov rdi, rbx
+    emit8(e, 0x48); emit8(e, 0xBE); emit64(e, (uint64_t)(uintptr_t)d);      // mov rsi, d
+    emit8(e, 0xBA); emit32(e, pc);                                          // mov edx, pc
+    emit8(e, 0x48); emit8(e, 0xB8); emit64(e, (uint64_t)(uintptr_t)&cpu_trace_retired); // mov rax, fn
+    emit8(e, 0xFF); emit8(e, 0xD0);                                         // call rax
+}
+
+/*
+ * emit_sample_cycle
+ * 作用：生成对标记指令（BlockOp.sample）开始前的信号存储采样，仿真时间为已执行指令数 + ahead，
+ *       语义与 sample_cycle 一致。
+ * 行为：
+ *   - 时间未前进时不变；
+ *   - 波形激励未打开或未到下一段变化时在本机代码内完成：交换 cur/prev，
+ *     R0-R13 的 bit0 经 pslld/movmskps 打包写入 cur[0]，时间跳过若干周期时 prev[0] 取同值；
+ *   - 否则调用 cpu_sample_cycle。
+ */
+static void emit_sample_cycle(JitEmit* e, uint32_t ahead) {
+    emit_mem64(e, 0x8B, EDX, OFF_RETIRED);                                  // mov rdx, [inst_retired]
+    emit8(e, 0x48); emit8(e, 0x81); emit8(e, 0xC2); emit32(e, ahead);        // add rdx, ahead
+    emit_mem64(e, 0x3B, EDX, OFF_SIG_TIME);                                 // cmp rdx, [sig.time]
+    uint8_t* same = emit_jcc(e, JE);
+    emit8(e, 0x80); emit8(e, 0xBB); emit32(e, OFF_STIM_EN); emit8(e, 0);    // cmp byte [stim.enabled], 0
+    uint8_t* quiet = emit_jcc(e, JE);
+    emit_mem64(e, 0x3B, EDX, OFF_STIM_NEXT);                                // cmp rdx, [stim.next_time]
+    uint8_t* due = emit_jcc(e, JAE);
+    patch_rel32(quiet, e->p);
+
+    for (uint32_t i = 0; i < 16; i += 4) {
+        emit8(e, 0xF3); emit8(e, 0x0F); emit8(e, 0x6F); emit8(e, 0x83); emit32(e, OFF_REG(i)); // movdqu xmm0, [regs+i]
+        emit8(e, 0x66); emit8(e, 0x0F); emit8(e, 0x72); emit8(e, 0xF0); emit8(e, 31);         // pslld xmm0, 31
+        emit8(e, 0x0F); emit8(e, 0x50); emit8(e, 0xC8);                                        // movmskps ecx, xmm0
+        if (i == 0) {
+            emit8(e, 0x89); emit8(e, 0xCE);                                 // mov esi, ecx
+        } else {
+            emit8(e, 0xC1); emit8(e, 0xE1); emit8(e, (uint8_t)i);           // shl ecx, i
+            emit8(e, 0x09); emit8(e, 0xCE);                                 // or esi, ecx
+        }
+    }
+    emit8(e, 0x81); emit8(e, 0xE6); emit32(e, (uint32_t)SIGNAL_STORE_REG_MASK); // and esi, mask
+    emit_mem64(e, 0x8B, EAX, OFF_SIG_CUR);                                  // mov rax, [sig.cur]
+    emit_mem64(e, 0x8B, ECX, OFF_SIG_PREV);                                 // mov rcx, [sig.prev]
+    emit_mem64(e, 0x89, EAX, OFF_SIG_PREV);                                 // 交换 cur/prev
+    emit_mem64(e, 0x89, ECX, OFF_SIG_CUR);
+    emit8(e, 0x48); emit8(e, 0x89); emit8(e, 0x31);                         // mov [rcx], rsi：cur[0]
+    emit_mem64(e, 0x8B, EDI, OFF_SIG_TIME);                                 // mov rdi, [sig.time]
+    emit8(e, 0x48); emit8(e, 0xFF); emit8(e, 0xC7);                         // inc rdi
+    emit8(e, 0x48); emit8(e, 0x39); emit8(e, 0xD7);                         // cmp rdi, rdx
+    emit8(e, 0x74); emit8(e, 3);                                            // je +3
+    emit8(e, 0x48); emit8(e, 0x89); emit8(e, 0x30);                         // mov [rax], rsi：prev[0]
+    emit_mem64(e, 0x89, EDX, OFF_SIG_TIME);                                 // mov [sig.time], rdx
+    uint8_t* done = emit_jmp(e);
+
+    patch_rel32(due, e->p);
+    emit8(e, 0x48); emit8(e, 0x89); emit8(e, 0xDF);                         // mov rdi, rbx
+    emit8(e, 0xBE); emit32(e, ahead);                                       // mov esi, ahead
+    emit8(e, 0x48); emit8(e, 0xB8); emit64(e, (uint64_t)(uintptr_t)&cpu_sample_cycle); // mov rax, fn
+    emit8(e, 0xFF); emit8(e, 0xD0);                                         // call rax
+    patch_rel32(same, e->p);
+    patch_rel32(done, e->p);
+}
+
+/*
+ * jit_init
+ * 作用：分配 JIT 代码区并打开 JIT。
+ * 返回：成功返回1；mmap 失败返回0，此时全部走解释器。
+ */
+int jit_init(JIT* jit) {
+    jit_free(jit);
+    void* p = mmap(NULL, JIT_CODE_SIZE, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+        fprintf(stderr, "%s[cpu][jit] code buffer mmap failed, using interpreter%s\n", ANSI_YELLOW, ANSI_RESET);
+        return 0;
+    }
+    jit->code = (uint8_t*)p;
+    jit->cap = JIT_CODE_SIZE;
+    jit->used = 0;
+    jit->enabled = 1;
+    jit->trace = LOG_ENABLED(LOG_TRACE);
+    return 1;
+}
+
+/*
+ * jit_free
+ * 作用：释放代码区并关闭 JIT。
+ */
+void jit_free(JIT* jit) {
+    if (jit->code)
+        munmap(jit->code, jit->cap);
+    memset(jit, 0, sizeof(*jit));
+}
+
+/*
+ * jit_compile
+ * 作用：将基本块的可编译前缀生成为本机代码。
+ * 行为：
+ *   - 按块内操作顺序收录，遇到首个含不可编译指令的操作停止（超级指令两条都须可编译）；
+ *   - 生成 void fn(CPU*)：rbx 保存 CPU*，逐条执行，trace 及以上级别时每条后调用 cpu_trace_retired，
+ *     否则末尾一次累计已执行指令数；标记指令前在本机代码内采样信号存储（emit_sample_cycle）；
+ *   - 整块可编译时另生成链接入口（b->jit_chain），依次检查解码缓存代数未变、块内定时器不会到期
+ *     （与调度循环的判断相同）与链接预算，任一不满足即返回调度循环；
+ *     块尾按静态出口比较 PC，命中已链接的出口直接跳到后继块的链接入口（jit->idle 时向后的出口先调用
+ *     cpu_idle_probe，与调度循环对经向后跳转到达的块的处理相同）；其余出口（未链接、ret、PC 为 0）
+ *     在 jit.last 留下本块后返回，由调度循环补上链接并据此判断下一块是否经向后跳转到达；
+ *     链接入口的检查不满足而返回时 jit.last 为空；
+ *   - 成功时设置 b->jit_code / b->jit_nops，其后的操作由解释器继续执行。
+ * 返回：生成了代码返回1；前缀为空或代码区不足返回0。
+ */
+int jit_compile(JIT* jit, BasicBlock* b) {
+    if (!jit->enabled)
+        return 0;
+
+    uint32_t nops = 0, ninsts = 0;
+    const BlockOp* op;
+    for (op = b->ops; op->op != BLOCK_OP_END; op++) {
+        if (!jit_covers(op->a) || (op->b && !jit_covers(op->b)))
+            break;
+        nops++;
+        ninsts += op->b ? 2 : 1;
+    }
+    if (nops == 0)
+        return 0;
+    int whole = op->op == BLOCK_OP_END;
+    if (jit->cap - jit->used < (size_t)ninsts * JIT_MAX_INST_CODE + JIT_MAX_BLOCK_CODE)
+        return 0;
+
+    if (mprotect(jit->code, jit->cap, PROT_READ | PROT_WRITE) != 0)
+        return 0;
+
+    uint8_t* start = jit->code + jit->used;
+    JitEmit e = { start };
+    uint8_t* out[4];
+    uint32_t nout = 0;
+    emit8(&e, 0x53);                                    // push rbx（同时使调用点栈 16 字节对齐）
+    emit8(&e, 0x48); emit8(&e, 0x89); emit8(&e, 0xFB);  // mov rbx, rdi
+
+    uint8_t* chain = NULL;
+    if (whole) {
+        uint8_t* body = emit_jmp(&e);
+        chain = e.p;
+        emit8(&e, 0x48); emit8(&e, 0xB8); emit64(&e, b->generation);       // mov rax, generation
+        emit_mem64(&e, 0x3B, EAX, OFF_GEN);                                 // cmp rax, [icache.generation]
+        out[nout++] = emit_jcc(&e, JNE);
+        emit_mem64(&e, 0x8B, EAX, OFF_RETIRED);                             // mov rax, [inst_retired]
+        emit8(&e, 0x48); emit8(&e, 0x05); emit32(&e, ninsts);               // add rax, ninsts
+        emit_mem64(&e, 0x3B, EAX, OFF_TIMER_NEXT);                          // cmp rax, [timers.next]
+        out[nout++] = emit_jcc(&e, JAE);
+        emit8(&e, 0x83); emit8(&e, 0xAB); emit32(&e, OFF_BUDGET); emit8(&e, 1); // sub dword [jit.budget], 1
+        out[nout++] = emit_jcc(&e, JB);
+        patch_rel32(body, e.p);
+    }
+
+    // trace 时前面各条已由 cpu_trace_retired 计入，否则块结束后才累计
+    uint32_t pc = b->start_pc, k = 0;
+    const DecodedInst* last = NULL;
+    for (uint32_t i = 0; i < nops; i++) {
+        op = &b->ops[i];
+        if (op->sample & BLOCK_SAMPLE_A)
+            emit_sample_cycle(&e, jit->trace ? 1 : k + 1);
+        emit_inst(&e, op->a, pc, jit->trace);
+        pc += op->a->length;
+        k++;
+        last = op->a;
+        if (op->b) {
+            if (op->sample & BLOCK_SAMPLE_B)
+                emit_sample_cycle(&e, jit->trace ? 1 : k + 1);
+            emit_inst(&e, op->b, pc, jit->trace);
+            pc += op->b->length;
+            k++;
+            last = op->b;
+        }
+    }
+    if (!jit->trace) {
+        emit8(&e, 0x48); emit8(&e, 0x81); emit8(&e, 0x83);                 // add qword [inst_retired], ninsts
+        emit32(&e, OFF_RETIRED); emit32(&e, ninsts);
+    }
+
+    uint32_t nexits = 0;
+    if (whole) {
+        uint32_t exits[2], target = pc + (uint32_t)last->offset;
+        if (last->op == INST_OP_JMP || last->op == INST_OP_BL) {
+            exits[nexits++] = target;
+        } else if (last->op >= INST_OP_JMPC_EQ && last->op <= INST_OP_JMPC_LE) {
+            exits[nexits++] = target;
+            exits[nexits++] = pc;
+        } else if (last->op != INST_OP_RET) {
+            exits[nexits++] = pc;
+        }
+        uint8_t* miss[2];
+        uint32_t nmiss = 0;
+        for (uint32_t x = 0; x < nexits; x++) {
+            b->jit_exit_pc[x] = exits[x];
+            b->jit_next[x] = NULL;
+            if (exits[x] == 0)
+                continue;
+            emit8(&e, 0x81); emit8(&e, 0xBB); emit32(&e, OFF_PC); emit32(&e, exits[x]); // cmp dword [pc], exit
+            uint8_t* other = emit_jcc(&e, JNE);
+            emit8(&e, 0x48); emit8(&e, 0xB8); emit64(&e, (uint64_t)(uintptr_t)&b->jit_next[x]); // mov rax, &next[x]
+            emit8(&e, 0x48); emit8(&e, 0x8B); emit8(&e, 0x00);             // mov rax, [rax]
+            emit8(&e, 0x48); emit8(&e, 0x85); emit8(&e, 0xC0);             // test rax, rax
+            miss[nmiss++] = emit_jcc(&e, JE);
+            if (jit->idle && exits[x] < pc) {
+                // 向后的出口：与调度循环相同，到达后继块前交给空转检测（可能推进仿真时间）；
+                // 未取快照且仍在间隔内时 cpu_idle_probe 只递减 cooldown，在此内联
+                emit8(&e, 0x80); emit8(&e, 0xBB); emit32(&e, OFF_IDLE_ARMED); emit8(&e, 0); // cmp byte [idle.armed], 0
+                uint8_t* armed = emit_jcc(&e, JNE);
+                emit8(&e, 0x83); emit8(&e, 0xBB); emit32(&e, OFF_IDLE_COOL); emit8(&e, 0);  // cmp dword [idle.cooldown], 0
+                uint8_t* due = emit_jcc(&e, JE);
+                emit8(&e, 0x83); emit8(&e, 0xAB); emit32(&e, OFF_IDLE_COOL); emit8(&e, 1);  // sub dword [idle.cooldown], 1
+                emit8(&e, 0xFF); emit8(&e, 0xE0);                           // jmp rax
+                patch_rel32(armed, e.p);
+                patch_rel32(due, e.p);
+                emit8(&e, 0x48); emit8(&e, 0x89); emit8(&e, 0xDF);         // mov rdi, rbx
+                emit8(&e, 0xBE); emit32(&e, exits[x]);                      // mov esi, exit
+                emit8(&e, 0x48); emit8(&e, 0xB8); emit64(&e, (uint64_t)(uintptr_t)&cpu_idle_probe); // mov rax, fn
+                emit8(&e, 0xFF); emit8(&e, 0xD0);                           // call rax
+                emit8(&e, 0x48); emit8(&e, 0xB8); emit64(&e, (uint64_t)(uintptr_t)&b->jit_next[x]); // mov rax, &next[x]
+                emit8(&e, 0x48); emit8(&e, 0x8B); emit8(&e, 0x00);         // mov rax, [rax]
+            }
+            emit8(&e, 0xFF); emit8(&e, 0xE0);                               // jmp rax
+            patch_rel32(other, e.p);
+        }
+        for (uint32_t x = 0; x < nmiss; x++)
+            patch_rel32(miss[x], e.p);
+        emit8(&e, 0x48); emit8(&e, 0xB8); emit64(&e, (uint64_t)(uintptr_t)b); // mov rax, b
+        emit_mem64(&e, 0x89, EAX, OFF_LAST);                                // mov [jit.last], rax
+    }
+
+    for (uint32_t x = 0; x < nout; x++)
+        patch_rel32(out[x], e.p);
+    emit8(&e, 0x5B);                                    // pop rbx
+    emit8(&e, 0xC3);                                    // ret
+
+    jit->used = (size_t)(e.p - jit->code);
+    jit->used = (jit->used + 15) & ~(size_t)15;
+    mprotect(jit->code, jit->cap, PROT_READ | PROT_EXEC);
+
+    b->jit_code = (void (*)(struct CPU*))(void*)start;
+    b->jit_nops = nops;
+    b->jit_ninsts = ninsts;
+    b->jit_chain = chain;
+    b->jit_nexits = nexits;
+    return 1;
+}
+
+/*
+ * jit_link
+ * 作用：from 的静态出口指向 to 的入口 PC 时，把该出口直接链接到 to 的链接入口。
+ * 行为：to 未整块编译（没有链接入口）时不链接，from 的该出口继续回到调度循环。
+ */
+void jit_link(BasicBlock* from, BasicBlock* to) {
+    if (!to->jit_chain)
+        return;
+    for (uint32_t x = 0; x < from->jit_nexits; x++)
+        if (from->jit_exit_pc[x] == to->start_pc)
+            from->jit_next[x] = to->jit_chain;
+}
+
+#else
+
+int jit_init(JIT* jit) {
+    memset(jit, 0, sizeof(*jit));
+    fprintf(stderr, "%s[cpu][jit] host is not x86-64 Linux, using interpreter%s\n", ANSI_YELLOW, ANSI_RESET);
+    return 0;
+}
+
+void jit_free(JIT* jit) {
+    memset(jit, 0, sizeof(*jit));
+}
+
+int jit_compile(JIT* jit, BasicBlock* b) {
+    return 0;
+}
+
+void jit_link(BasicBlock* from, BasicBlock* to) {
+}
+
+#endif
@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "../include/loader.h"
+#include "../include/color.h"
+#include "../include/log.h"
+
+/*
+ * dump_image
+ * 作用：以十六进制打印已加载的镜像（--dump-image），每行 16 字节。
+ * 行为：每行先格式化到行缓冲区再整行输出，输出与逐字节打印时相同。
+ */
+static void dump_image(const uint8_t* mem, size_t bytes) {
+    char line[512];
+    log_printf("%s[MEMORY INFO]:%s", ANSI_BOLD, ANSI_RESET);
+    for (size_t i = 0; i < bytes; i += 16) {
+        int n = snprintf(line, sizeof(line), "\n   %4s%.8lx:%s ", ANSI_YELLOW, (unsigned long)i, ANSI_RESET);
+        for (size_t j = i; j < bytes && j < i + 16; j++)
+            n += snprintf(line + n, sizeof(line) - (size_t)n, "%s%02x%s ", ANSI_BOLD, mem[j], ANSI_RESET);
+        log_printf("%s", line);
+    }
+    log_printf("\n");
+}
+
+/*
+ * read_file
+ * 作用：将二进制文件加载到CPU的DRAM中。
+ * 行为：
+ *   - 打开指定的二进制文件并取文件大小，超过 DRAM 大小时截断；
+ *   - 以写时复制方式映射为 DRAM 起始的页（dram_map_image），不分配缓冲区、不拷贝；
+ *   - dump 非 0（--dump-image）时打印内存内容；
+ *   - 关闭文件（映射在文件关闭后仍有效）。
+ * 示例：
+ *   read_file(cpu, "program.bin", 0) => 1024 (返回加载的字节数)
+ */
+size_t read_file(CPU* cpu, const char *filename, int dump) {
+    if (!cpu->bus.dram.pages)
+        return 0;
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        log_printf("%sUnable to open file %s%s\n", ANSI_RED, filename, ANSI_RESET);
+        return 0;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) { close(fd); log_printf("%sStat error%s\n", ANSI_RED, ANSI_RESET); return 0; }
+    size_t fileLen = (size_t)st.st_size;
+    if (fileLen == 0) {
+        log_printf("%sError: file is empty, nothing to load%s!\n", ANSI_RED, ANSI_RESET);
+        close(fd);
+        return 0;
+    }
+
+    size_t copy_bytes = fileLen;
+    if (copy_bytes > cpu->bus.dram.size) {
+        log_printf("%sWarning: file too large, truncating to %zu bytes%s\n", ANSI_YELLOW, (size_t)cpu->bus.dram.size, ANSI_RESET);
+        copy_bytes = (size_t)cpu->bus.dram.size;
+    }
+    if (!dram_map_image(&cpu->bus.dram, fd, copy_bytes)) {
+        log_printf("%sRead error (%s)%s\n", ANSI_RED, filename, ANSI_RESET);
+        close(fd);
+        return 0;
+    }
+    close(fd);
+
+    if (dump)
+        dump_image(cpu->bus.dram.image, copy_bytes);
+    if (LOG_ENABLED(LOG_SUMMARY))
+        log_printf("\n%sSuccessfully loaded %s (%zu bytes)%s!\n", ANSI_BOLD, filename, copy_bytes, ANSI_RESET);
+    return copy_bytes;
+}
@@ -0,0 +1,423 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include "../include/log.h"
+#include "../include/color.h"
+
+LOG_LEVEL g_log_level = LOG_FULL;
+
+static const char* log_level_names[] = { "quiet", "summary", "trace", "full" };
+
+void set_log_level(LOG_LEVEL level) {
+    g_log_level = level;
+}
+
+/*
+ * log_level_parse
+ * 作用：解析命令行中的日志级别名。
+ * 返回：成功返回1并写入 level，未知名称返回0。
+ * 示例：
+ *   log_level_parse("trace", &level) => 1, level = LOG_TRACE
+ */
+int log_level_parse(const char* name, LOG_LEVEL* level) {
+    for (int i = 0; i <= LOG_FULL; i++) {
+        if (strcmp(name, log_level_names[i]) == 0) {
+            *level = (LOG_LEVEL)i;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+const char* log_level_name(LOG_LEVEL level) {
+    return level <= LOG_FULL ? log_level_names[level] : "?";
+}
+
+//=====================================================================================
+//   异步 stdout 后端
+//=====================================================================================
+
+// 单个线程的环形缓冲区：head 只由所属线程推进，tail 只由写线程推进
+typedef struct LogRing {
+    char*            buf;
+    _Atomic uint64_t head;
+    _Atomic uint64_t tail;
+    _Atomic uint64_t dropped;
+    struct LogRing*  next;
+} LogRing;
+
+static LogRing* _Atomic log_rings;          // 已注册的线程缓冲区（只增不减）
+static _Atomic int      log_async_on;
+static _Atomic int      log_async_quit;
+static LOG_BACKPRESSURE log_policy;
+static pthread_t        log_writer;
+static __thread LogRing* log_tls_ring;
+
+static const char* log_bp_names[] = { "block", "drop" };
+
+/*
+ * log_backpressure_parse
+ * 作用：解析 --async-log 的策略名（block/drop）。
+ * 返回：成功返回1并写入 policy，未知名称返回0。
+ */
+int log_backpressure_parse(const char* name, LOG_BACKPRESSURE* policy) {
+    for (int i = 0; i <= LOG_BP_DROP; i++) {
+        if (strcmp(name, log_bp_names[i]) == 0) {
+            *policy = (LOG_BACKPRESSURE)i;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void log_pause(void) {
+    struct timespec ts = { 0, 50 * 1000 };
+    nanosleep(&ts, NULL);
+}
+
+// 当前线程的缓冲区，首次调用时分配并挂到全局链表；内存不足时返回 NULL，调用方改为同步写 stdout
+static LogRing* log_ring_get(void) {
+    LogRing* r = log_tls_ring;
+    if (r)
+        return r;
+    r = calloc(1, sizeof(LogRing));
+    if (!r)
+        return NULL;
+    r->buf = malloc(LOG_ASYNC_BUF_SIZE);
+    if (!r->buf) {
+        free(r);
+        return NULL;
+    }
+    r->next = atomic_load(&log_rings);
+    while (!atomic_compare_exchange_weak(&log_rings, &r->next, r))
+        ;
+    log_tls_ring = r;
+    return r;
+}
+
+/*
+ * log_ring_put
+ * 作用：将一条已格式化的消息整体放入当前线程的缓冲区。
+ * 行为：
+ *   - 空间不足时按策略等待写线程（block）或丢弃并计数（drop）；
+ *   - 超过缓冲区容量的消息按块分段放入（仅 block 策略）。
+ */
+static void log_ring_put(LogRing* r, const char* msg, size_t n) {
+    uint64_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    while (n > 0) {
+        size_t chunk = n < LOG_ASYNC_BUF_SIZE ? n : LOG_ASYNC_BUF_SIZE;
+        while (LOG_ASYNC_BUF_SIZE - (head - atomic_load_explicit(&r->tail, memory_order_acquire)) < chunk) {
+            if (log_policy == LOG_BP_DROP) {
+                atomic_fetch_add_explicit(&r->dropped, 1, memory_order_relaxed);
+                return;
+            }
+            log_pause();
+        }
+        size_t off = head & (LOG_ASYNC_BUF_SIZE - 1);
+        size_t first = LOG_ASYNC_BUF_SIZE - off < chunk ? LOG_ASYNC_BUF_SIZE - off : chunk;
+        memcpy(r->buf + off, msg, first);
+        memcpy(r->buf, msg + first, chunk - first);
+        head += chunk;
+        atomic_store_explicit(&r->head, head, memory_order_release);
+        msg += chunk;
+        n -= chunk;
+    }
+}
+
+//=====================================================================================
+//   延迟格式化事件文件
+//=====================================================================================
+int g_log_deferred;
+static int    log_dfd = -1;
+static char*  log_dbuf;
+static size_t log_dused;
+
+static int log_write_all(int fd, const char* p, size_t bytes) {
+    while (bytes > 0) {
+        ssize_t n = write(fd, p, bytes);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return 0;
+        p += n;
+        bytes -= (size_t)n;
+    }
+    return 1;
+}
+
+static void log_deferred_flush(void) {
+    if (log_dused && !log_write_all(log_dfd, log_dbuf, log_dused))
+        fprintf(stderr, "%s[log] deferred log write failed%s\n", ANSI_RED, ANSI_RESET);
+    log_dused = 0;
+}
+
+/*
+ * log_event
+ * 作用：追加一条延迟格式化事件（事件号 + n 个原始参数），缓冲区满时整块写出。
+ */
+void log_event(LOG_EVENT ev, uint16_t n, const uint32_t* args) {
+    size_t bytes = sizeof(LogEventHdr) + (size_t)n * sizeof(uint32_t);
+    if (log_dused + bytes > LOG_DEFERRED_BUF_SIZE)
+        log_deferred_flush();
+    LogEventHdr h = { (uint16_t)ev, n };
+    memcpy(log_dbuf + log_dused, &h, sizeof(h));
+    memcpy(log_dbuf + log_dused + sizeof(h), args, (size_t)n * sizeof(uint32_t));
+    log_dused += bytes;
+}
+
+// 文本按不超过 64KB 的 TEXT 事件写入
+static void log_deferred_text(const char* msg, size_t n) {
+    while (n > 0) {
+        size_t chunk = n < 0xFFFF ? n : 0xFFFF;
+        if (log_dused + sizeof(LogEventHdr) + chunk > LOG_DEFERRED_BUF_SIZE)
+            log_deferred_flush();
+        LogEventHdr h = { LOG_EV_TEXT, (uint16_t)chunk };
+        memcpy(log_dbuf + log_dused, &h, sizeof(h));
+        memcpy(log_dbuf + log_dused + sizeof(h), msg, chunk);
+        log_dused += sizeof(h) + chunk;
+        msg += chunk;
+        n -= chunk;
+    }
+}
+
+static void log_install_signal_handlers(void);
+
+/*
+ * log_deferred_open
+ * 作用：打开延迟格式化事件文件（--log-deferred），此后 stdout 日志全部写入该文件。
+ * 返回：成功返回1，失败打印错误并返回0。
+ */
+int log_deferred_open(const char* path) {
+    log_dfd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    log_dbuf = malloc(LOG_DEFERRED_BUF_SIZE);
+    if (log_dfd < 0 || !log_dbuf) {
+        fprintf(stderr, "%s[log] open failed: %s%s\n", ANSI_RED, path, ANSI_RESET);
+        if (log_dfd >= 0)
+            close(log_dfd);
+        free(log_dbuf);
+        log_dfd = -1;
+        log_dbuf = NULL;
+        return 0;
+    }
+    LogDeferredHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, LOG_DEFERRED_MAGIC, sizeof(LOG_DEFERRED_MAGIC));
+    h.version = LOG_DEFERRED_VERSION;
+    memcpy(log_dbuf, &h, sizeof(h));
+    log_dused = sizeof(h);
+
+    fflush(stdout);
+    g_log_deferred = 1;
+    atexit(log_deferred_close);
+    log_install_signal_handlers();
+    return 1;
+}
+
+/*
+ * log_deferred_close
+ * 作用：写出剩余事件并关闭事件文件，之后恢复直接输出。
+ */
+void log_deferred_close(void) {
+    if (!g_log_deferred)
+        return;
+    g_log_deferred = 0;
+    log_deferred_flush();
+    close(log_dfd);
+    free(log_dbuf);
+    log_dfd = -1;
+    log_dbuf = NULL;
+}
+
+/*
+ * log_write
+ * 作用：输出已渲染好的 n 字节文本（不经格式解析），后端与 log_printf 相同。
+ */
+int log_write(const char* s, size_t n) {
+    if (g_log_deferred) {
+        log_deferred_text(s, n);
+        return (int)n;
+    }
+    if (!atomic_load_explicit(&log_async_on, memory_order_relaxed))
+        return (int)fwrite(s, 1, n, stdout);
+    LogRing* r = log_ring_get();
+    if (!r)
+        log_write_all(STDOUT_FILENO, s, n);
+    else if (n > 0)
+        log_ring_put(r, s, n);
+    return (int)n;
+}
+
+/*
+ * log_printf
+ * 作用：printf 的替代入口，stdout 上的日志都经由此处。
+ * 行为：未打开异步模式时等同 vprintf；打开后格式化到栈上（过长时临时分配）再放入线程缓冲区；
+ *       延迟格式化模式下作为 TEXT 事件写入事件文件。
+ */
+int log_printf(const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    if (!g_log_deferred && !atomic_load_explicit(&log_async_on, memory_order_relaxed)) {
+        int n = vprintf(fmt, ap);
+        va_end(ap);
+        return n;
+    }
+
+    char local[512];
+    va_list ap2;
+    va_copy(ap2, ap);
+    if (g_log_deferred) {
+        int n = vsnprintf(local, sizeof(local), fmt, ap);
+        va_end(ap);
+        char* msg = n >= (int)sizeof(local) ? malloc((size_t)n + 1) : local;
+        if (msg != local && msg)
+            vsnprintf(msg, (size_t)n + 1, fmt, ap2);
+        va_end(ap2);
+        if (msg && n > 0)
+            log_deferred_text(msg, (size_t)n);
+        if (msg != local)
+            free(msg);
+        return n;
+    }
+    int n = vsnprintf(local, sizeof(local), fmt, ap);
+    va_end(ap);
+    char* msg = local;
+    if (n >= (int)sizeof(local)) {
+        msg = malloc((size_t)n + 1);
+        if (msg)
+            vsnprintf(msg, (size_t)n + 1, fmt, ap2);
+    }
+    va_end(ap2);
+
+    LogRing* r = log_ring_get();
+    if (msg && n > 0) {
+        if (r)
+            log_ring_put(r, msg, (size_t)n);
+        else
+            log_write_all(STDOUT_FILENO, msg, (size_t)n);
+    }
+    if (msg != local)
+        free(msg);
+    return n;
+}
+
+// 将 ring 中已提交的内容写到 stdout，返回写出的字节数
+static size_t log_ring_drain(LogRing* r) {
+    uint64_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    uint64_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+    size_t total = (size_t)(head - tail);
+    size_t left = total;
+    while (left > 0) {
+        size_t off = tail & (LOG_ASYNC_BUF_SIZE - 1);
+        size_t chunk = LOG_ASYNC_BUF_SIZE - off < left ? LOG_ASYNC_BUF_SIZE - off : left;
+        ssize_t w = write(STDOUT_FILENO, r->buf + off, chunk);
+        if (w <= 0) {
+            if (w < 0 && errno == EINTR)
+                continue;
+            w = (ssize_t)chunk;     // stdout 不可写：丢弃，避免仿真线程永久阻塞
+        }
+        tail += (uint64_t)w;
+        left -= (size_t)w;
+        atomic_store_explicit(&r->tail, tail, memory_order_release);
+    }
+    return total;
+}
+
+static int log_rings_empty(void) {
+    for (LogRing* r = atomic_load(&log_rings); r; r = r->next)
+        if (atomic_load(&r->head) != atomic_load(&r->tail))
+            return 0;
+    return 1;
+}
+
+// assert 失败或被中断/终止时：写出延迟事件；异步写线程仍在运行，等缓冲区排空（最多约 1s）后交给原处理
+static const int log_flush_signals[] = { SIGABRT, SIGINT, SIGTERM };
+static struct sigaction log_prev_actions[sizeof(log_flush_signals) / sizeof(log_flush_signals[0])];
+
+static void log_signal_handler(int sig) {
+    if (g_log_deferred && log_dused)
+        log_write_all(log_dfd, log_dbuf, log_dused);
+    for (int i = 0; i < 20000 && !log_rings_empty(); i++)
+        log_pause();
+    for (size_t i = 0; i < sizeof(log_flush_signals) / sizeof(log_flush_signals[0]); i++)
+        if (log_flush_signals[i] == sig)
+            sigaction(sig, &log_prev_actions[i], NULL);
+    raise(sig);
+}
+
+static void log_install_signal_handlers(void) {
+    static int installed;
+    if (installed)
+        return;
+    installed = 1;
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = log_signal_handler;
+    for (size_t i = 0; i < sizeof(log_flush_signals) / sizeof(log_flush_signals[0]); i++)
+        sigaction(log_flush_signals[i], &sa, &log_prev_actions[i]);
+}
+
+static void* log_writer_main(void* arg) {
+    (void)arg;
+    while (1) {
+        int quit = atomic_load(&log_async_quit);
+        size_t n = 0;
+        for (LogRing* r = atomic_load(&log_rings); r; r = r->next)
+            n += log_ring_drain(r);
+        if (quit && n == 0)
+            break;
+        if (n == 0)
+            log_pause();
+    }
+    return NULL;
+}
+
+/*
+ * log_async_start
+ * 作用：打开异步 stdout 后端（--async-log）。
+ * 行为：
+ *   - 先刷新 stdio 中已缓冲的输出，保证先后顺序；
+ *   - 启动后台写线程，进程退出（exit）、assert 失败或被中断时排空缓冲区。
+ * 返回：成功返回1，线程创建失败返回0（继续同步输出）。
+ */
+int log_async_start(LOG_BACKPRESSURE policy) {
+    if (atomic_load(&log_async_on))
+        return 1;
+    fflush(stdout);
+    log_policy = policy;
+    atomic_store(&log_async_quit, 0);
+    if (pthread_create(&log_writer, NULL, log_writer_main, NULL) != 0) {
+        fprintf(stderr, "%s[log] unable to start writer thread, using synchronous output%s\n", ANSI_YELLOW, ANSI_RESET);
+        return 0;
+    }
+    atomic_store(&log_async_on, 1);
+    atexit(log_async_stop);
+    log_install_signal_handlers();
+    return 1;
+}
+
+/*
+ * log_async_stop
+ * 作用：排空所有线程缓冲区并结束写线程；drop 策略下报告丢弃的消息数。
+ */
+void log_async_stop(void) {
+    if (!atomic_exchange(&log_async_on, 0))
+        return;
+    atomic_store(&log_async_quit, 1);
+    pthread_join(log_writer, NULL);
+
+    uint64_t dropped = 0;
+    for (LogRing* r = atomic_load(&log_rings); r; r = r->next)
+        dropped += atomic_load(&r->dropped);
+    if (dropped)
+        fprintf(stderr, "%s[log] dropped %" PRIu64 " messages (buffer full)%s\n", ANSI_YELLOW, dropped, ANSI_RESET);
+}
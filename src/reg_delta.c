@@ -0,0 +1,45 @@
+#include <string.h>
+
+#include "../include/reg_delta.h"
+#include "../include/cpu.h"
+
+#define TSL_REG_SIGNAL_NAME(name, width) #name,
+const char* reg_signal_names[REG_SIG_COUNT] = {
+    TSL_REG_SIGNALS(TSL_REG_SIGNAL_NAME)
+};
+#undef TSL_REG_SIGNAL_NAME
+
+#define TSL_REG_SIGNAL_WIDTH(name, width) width,
+const uint8_t reg_signal_widths[REG_SIG_COUNT] = {
+    TSL_REG_SIGNALS(TSL_REG_SIGNAL_WIDTH)
+};
+#undef TSL_REG_SIGNAL_WIDTH
+
+/*
+ * reg_delta_sample
+ * 作用：采样当前可观测寄存器并与上一次采样比较。
+ * 行为：
+ *   - 定时器取按已执行指令数推算的计数值，与 dump_registers 一致；
+ *   - 更新 prev，返回变化位图（bit i 对应 REG_SIGNAL i），首次采样返回全部位。
+ * 示例：
+ *   add r1 = r1 + r2 之后 => (1 << REG_SIG_R1) | (1 << REG_SIG_PC)（及使能定时器的 T0/T1）
+ */
+uint32_t reg_delta_sample(REG_DELTA* rd, const CPU* cpu, uint64_t cur[REG_SIG_COUNT]) {
+    for (int i = 0; i < 14; i++)
+        cur[REG_SIG_R0 + i] = cpu->regs[i];
+    cur[REG_SIG_RET] = cpu->ret_reg;
+    cur[REG_SIG_C0] = cpu->regs[14];
+    cur[REG_SIG_C1] = cpu->regs[15];
+    cur[REG_SIG_T0] = timer_sched_value(&cpu->timers, 0, cpu->inst_retired);
+    cur[REG_SIG_T1] = timer_sched_value(&cpu->timers, 1, cpu->inst_retired);
+    cur[REG_SIG_PC] = cpu->pc;
+    cur[REG_SIG_DOMAIN] = cpu->domain;
+
+    uint32_t changed = 0;
+    for (int i = 0; i < REG_SIG_COUNT; i++)
+        if (!rd->valid || cur[i] != rd->prev[i])
+            changed |= 1u << i;
+    memcpy(rd->prev, cur, sizeof(rd->prev));
+    rd->valid = 1;
+    return changed;
+}
@@ -0,0 +1,86 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "../include/signal_store.h"
+#include "../include/color.h"
+
+// 两组采样值与各边沿类别的位列数组共 2 + EDGE_CLASS_COUNT 组，一次分配
+#define SIGNAL_STORE_ARRAYS (2 + EDGE_CLASS_COUNT)
+
+/*
+ * signal_store_init
+ * 作用：建立寄存器列的存储（cpu_init 调用），当前/上一周期值均为 0。
+ * 返回：成功返回1，内存不足返回0。
+ */
+int signal_store_init(SIGNAL_STORE* s) {
+    memset(s, 0, sizeof(*s));
+    uint64_t* p = NULL;
+    size_t bytes = (size_t)SIGNAL_STORE_WORDS * SIGNAL_STORE_ARRAYS * sizeof(uint64_t);
+    if (posix_memalign((void**)&p, 16, bytes) != 0) {
+        fprintf(stderr, "%s[signal] out of memory%s\n", ANSI_RED, ANSI_RESET);
+        return 0;
+    }
+    memset(p, 0, bytes);
+    s->words = p;
+    s->cur = p;
+    s->prev = p + SIGNAL_STORE_WORDS;
+    s->cls = p + 2 * SIGNAL_STORE_WORDS;
+    s->nwords = SIGNAL_STORE_WORDS;
+    s->classified = UINT64_MAX;
+    return 1;
+}
+
+/*
+ * signal_store_classify
+ * 作用：按本周期的 cur/prev 一次计算全部列的边沿类别。
+ * 行为：
+ *   - P = ~prev & cur，N = prev & ~cur，T = prev ^ cur，
+ *     L = ~(prev | cur)，H = prev & cur，S = ~(prev ^ cur)；
+ *   - 支持 SSE2 时每次处理 128 列，否则按 64 位字处理。
+ */
+void signal_store_classify(SIGNAL_STORE* s) {
+    uint64_t* P = s->cls + EDGE_CLASS_P * (size_t)s->nwords;
+    uint64_t* N = s->cls + EDGE_CLASS_N * (size_t)s->nwords;
+    uint64_t* T = s->cls + EDGE_CLASS_T * (size_t)s->nwords;
+    uint64_t* L = s->cls + EDGE_CLASS_L * (size_t)s->nwords;
+    uint64_t* H = s->cls + EDGE_CLASS_H * (size_t)s->nwords;
+    uint64_t* S = s->cls + EDGE_CLASS_S * (size_t)s->nwords;
+#if defined(__SSE2__)
+    const __m128i ones = _mm_set1_epi32(-1);
+    for (uint32_t i = 0; i < s->nwords; i += 2) {
+        __m128i p = _mm_load_si128((const __m128i*)(s->prev + i));
+        __m128i c = _mm_load_si128((const __m128i*)(s->cur + i));
+        __m128i t = _mm_xor_si128(p, c);
+        _mm_store_si128((__m128i*)(P + i), _mm_andnot_si128(p, c));
+        _mm_store_si128((__m128i*)(N + i), _mm_andnot_si128(c, p));
+        _mm_store_si128((__m128i*)(T + i), t);
+        _mm_store_si128((__m128i*)(L + i), _mm_xor_si128(_mm_or_si128(p, c), ones));
+        _mm_store_si128((__m128i*)(H + i), _mm_and_si128(p, c));
+        _mm_store_si128((__m128i*)(S + i), _mm_xor_si128(t, ones));
+    }
+#else
+    for (uint32_t i = 0; i < s->nwords; i++) {
+        uint64_t p = s->prev[i], c = s->cur[i];
+        P[i] = ~p & c;
+        N[i] = p & ~c;
+        T[i] = p ^ c;
+        L[i] = ~(p | c);
+        H[i] = p & c;
+        S[i] = ~(p ^ c);
+    }
+#endif
+    s->classified = s->time;
+}
+
+/*
+ * signal_store_free
+ * 作用：释放全部位列数组。
+ */
+void signal_store_free(SIGNAL_STORE* s) {
+    free(s->words);
+    memset(s, 0, sizeof(*s));
+}
@@ -0,0 +1,299 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../include/stimulus.h"
+#include "../include/info_db.h"
+#include "../include/color.h"
+#include "../include/log.h"
+
+// 已解码的前缀超过该长度后交还内核
+#define STIM_RELEASE_CHUNK  (64u << 20)
+
+static inline int stim_space(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// 读取下一个以空白分隔的词，文件结束返回0
+static int stim_token(STIMULUS* s, const char** tok, size_t* len) {
+    while (s->pos < s->size && stim_space(s->map[s->pos]))
+        s->pos++;
+    if (s->pos >= s->size)
+        return 0;
+    size_t start = s->pos;
+    while (s->pos < s->size && !stim_space(s->map[s->pos]))
+        s->pos++;
+    *tok = s->map + start;
+    *len = s->pos - start;
+    return 1;
+}
+
+static int stim_is(const char* tok, size_t len, const char* word) {
+    return strlen(word) == len && memcmp(tok, word, len) == 0;
+}
+
+// 跳过到下一个 $end（含）
+static void stim_skip_to_end(STIMULUS* s) {
+    const char* tok;
+    size_t len;
+    while (stim_token(s, &tok, &len) && !stim_is(tok, len, "$end"))
+        ;
+}
+
+// VCD 标识符 -> 64 位键：不超过 8 字节时直接打包（可打印字符，最高位为 0），否则取 FNV-1a 并置最高位
+static uint64_t stim_id_key(const char* id, size_t len) {
+    uint64_t key = 0;
+    if (len <= 8) {
+        memcpy(&key, id, len);
+        return key;
+    }
+    key = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < len; i++)
+        key = (key ^ (uint8_t)id[i]) * 0x100000001b3ull;
+    return key | (1ull << 63);
+}
+
+static inline uint32_t stim_slot(const STIMULUS* s, uint64_t key) {
+    return (uint32_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & s->slot_mask;
+}
+
+static STIM_SIGNAL* stim_find(STIMULUS* s, uint64_t key) {
+    for (uint32_t i = stim_slot(s, key); s->slots[i]; i = (i + 1) & s->slot_mask)
+        if (s->signals[s->slots[i] - 1].id == key)
+            return &s->signals[s->slots[i] - 1];
+    return NULL;
+}
+
+static uint32_t stim_nwords(const STIM_SIGNAL* sig) {
+    return sig->sig->nwords ? sig->sig->nwords : 1;
+}
+
+/*
+ * stim_apply
+ * 作用：应用一次值变化：bits 为二进制串（最高位在前，x/z 按 0），不足位宽时高位补 0。
+ * 行为：新值写入 cur，并更新信号索引中各拆分字地址的值。
+ */
+static void stim_apply(STIM_SIGNAL* sig, const char* bits, size_t len) {
+    uint32_t n = stim_nwords(sig);
+    memset(sig->cur, 0, n * sizeof(uint32_t));
+    for (size_t i = 0; i < len && i < (size_t)n * 32; i++)
+        if (bits[len - 1 - i] == '1')
+            sig->cur[i / 32] |= 1u << (i % 32);
+    for (uint32_t k = 0; k < n; k++)
+        set_signal_value(sig->sig->nwords ? sig->sig->words[k] : sig->sig->addr, sig->cur[k]);
+}
+
+// 解析头部的 $var，与 signal_split.db 同名（作用域.名称 或 名称）的变量加入订阅
+static int stim_subscribe(STIMULUS* s, const char* scope, const char* id, size_t id_len, const char* ref, size_t ref_len) {
+    char name[1024];
+    s->nvars++;
+    snprintf(name, sizeof(name), "%s%s%.*s", scope, scope[0] ? "." : "", (int)ref_len, ref);
+    const SIGNAL_SPLIT* sig = find_signal_split(name);
+    if (!sig) {
+        snprintf(name, sizeof(name), "%.*s", (int)ref_len, ref);
+        sig = find_signal_split(name);
+    }
+    if (!sig)
+        return 1;
+    STIM_SIGNAL* grown = (STIM_SIGNAL*)realloc(s->signals, (s->nsignals + 1) * sizeof(STIM_SIGNAL));
+    if (!grown)
+        return 0;
+    s->signals = grown;
+    memset(&s->signals[s->nsignals], 0, sizeof(STIM_SIGNAL));
+    s->signals[s->nsignals].id = stim_id_key(id, id_len);
+    s->signals[s->nsignals].sig = sig;
+    s->nsignals++;
+    return 1;
+}
+
+/*
+ * stim_parse_header
+ * 作用：解析到 $enddefinitions，按 $scope/$upscope 维护层次名并订阅匹配的 $var。
+ * 返回：成功返回1，文件格式不完整返回0。
+ */
+static int stim_parse_header(STIMULUS* s) {
+    char scope[1024] = "";
+    size_t depth_len[64];
+    int depth = 0;
+    const char* tok;
+    size_t len;
+    while (stim_token(s, &tok, &len)) {
+        if (stim_is(tok, len, "$enddefinitions")) {
+            stim_skip_to_end(s);
+            return 1;
+        } else if (stim_is(tok, len, "$scope")) {
+            const char* name;
+            size_t name_len;
+            if (!stim_token(s, &tok, &len) || !stim_token(s, &name, &name_len))
+                return 0;
+            size_t cur = strlen(scope);
+            if (depth < 64)
+                depth_len[depth] = cur;
+            depth++;
+            snprintf(scope + cur, sizeof(scope) - cur, "%s%.*s", cur ? "." : "", (int)name_len, name);
+            stim_skip_to_end(s);
+        } else if (stim_is(tok, len, "$upscope")) {
+            if (depth > 0 && --depth < 64)
+                scope[depth_len[depth]] = '\0';
+            stim_skip_to_end(s);
+        } else if (stim_is(tok, len, "$var")) {
+            const char *id, *ref;
+            size_t id_len, ref_len;
+            if (!stim_token(s, &tok, &len) || !stim_token(s, &tok, &len)       // 类型、位宽
+                || !stim_token(s, &id, &id_len) || !stim_token(s, &ref, &ref_len))
+                return 0;
+            if (!stim_subscribe(s, scope, id, id_len, ref, ref_len))
+                return 0;
+            stim_skip_to_end(s);
+        } else if (tok[0] == '$') {
+            stim_skip_to_end(s);
+        }
+    }
+    return 0;
+}
+
+/*
+ * stimulus_open
+ * 作用：打开波形激励文件（--stimulus），须在信号索引建立之后调用。
+ * 行为：
+ *   - 只读 mmap 整个文件并提示顺序访问，不读入内存；
+ *   - 解析头部，订阅与 signal_split.db 同名的变量，为其分配当前值与标识符查找表；
+ *   - summary 及以上级别打印订阅数量。
+ * 返回：成功返回1，失败打印错误并返回0。
+ * 示例：
+ *   stimulus_open(&cpu->stim, "capture.vcd") => 1，之后 load top.op 的拆分字地址随仿真时间取到波形中的值
+ */
+int stimulus_open(STIMULUS* s, const char* path) {
+    memset(s, 0, sizeof(*s));
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0) {
+        fprintf(stderr, "%s[stimulus] open failed: %s%s\n", ANSI_RED, path, ANSI_RESET);
+        if (fd >= 0)
+            close(fd);
+        return 0;
+    }
+    void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        fprintf(stderr, "%s[stimulus] mmap failed: %s%s\n", ANSI_RED, path, ANSI_RESET);
+        return 0;
+    }
+    madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+    s->map = (const char*)p;
+    s->size = (size_t)st.st_size;
+
+    if (!stim_parse_header(s)) {
+        fprintf(stderr, "%s[stimulus] %s: missing $enddefinitions%s\n", ANSI_RED, path, ANSI_RESET);
+        stimulus_close(s);
+        return 0;
+    }
+
+    uint32_t total = 0, cap = 16;
+    for (uint32_t i = 0; i < s->nsignals; i++)
+        total += stim_nwords(&s->signals[i]);
+    while (cap < s->nsignals * 2)
+        cap <<= 1;
+    s->words = (uint32_t*)calloc((size_t)total + 1, sizeof(uint32_t));
+    s->slots = (uint32_t*)calloc(cap, sizeof(uint32_t));
+    if (!s->words || !s->slots) {
+        fprintf(stderr, "%s[stimulus] out of memory%s\n", ANSI_RED, ANSI_RESET);
+        stimulus_close(s);
+        return 0;
+    }
+    s->slot_mask = cap - 1;
+    uint32_t* w = s->words;
+    for (uint32_t i = 0; i < s->nsignals; i++) {
+        STIM_SIGNAL* sig = &s->signals[i];
+        sig->cur = w;
+        w += stim_nwords(sig);
+        if (stim_find(s, sig->id))
+            continue;   // 同一标识符的别名只回放到第一个匹配的信号
+        uint32_t j = stim_slot(s, sig->id);
+        while (s->slots[j])
+            j = (j + 1) & s->slot_mask;
+        s->slots[j] = i + 1;
+    }
+
+    s->next_time = 0;   // 第一个 #t 之前的变化视为时刻 0
+    s->enabled = 1;
+    if (LOG_ENABLED(LOG_SUMMARY)) {
+        print_color(ANSI_BOLD);
+        log_printf("[STIMULUS]:\n");
+        print_color(ANSI_RESET);
+        print_color(ANSI_BOLD_WHITE);
+        log_printf("   %s SIGNALS:%u/%u\n", path, s->nsignals, s->nvars);
+        print_color(ANSI_RESET);
+    }
+    return 1;
+}
+
+/*
+ * stimulus_advance_to
+ * 作用：解码并应用时间戳不超过 now 的全部值变化（now 为已执行指令数，一个时间单位对应一条指令）。
+ * 行为：
+ *   - 逐段读取 "#t" 与其后的变化（bN..N id / 0id / 1id / xid / zid），未订阅的标识符跳过；
+ *   - 遇到时间戳大于 now 的段时停下，记为 next_time，下次推进从该处继续，并整批重新装配宽信号；
+ *   - 已越过的文件前缀按 64MB 交还内核。
+ */
+void stimulus_advance_to(STIMULUS* s, uint64_t now) {
+    const char* tok;
+    size_t len;
+    while (s->next_time <= now) {
+        if (!stim_token(s, &tok, &len)) {
+            s->next_time = UINT64_MAX;
+            break;
+        }
+        char c = tok[0];
+        if (c == '#') {
+            uint64_t t = 0;
+            for (size_t i = 1; i < len && tok[i] >= '0' && tok[i] <= '9'; i++)
+                t = t * 10 + (uint64_t)(tok[i] - '0');
+            s->next_time = t;
+        } else if (c == '$') {
+            if (stim_is(tok, len, "$comment"))
+                stim_skip_to_end(s);
+        } else if (c == 'b' || c == 'B') {
+            const char* id;
+            size_t id_len;
+            if (!stim_token(s, &id, &id_len))
+                continue;
+            STIM_SIGNAL* sig = stim_find(s, stim_id_key(id, id_len));
+            if (sig) {
+                stim_apply(sig, tok + 1, len - 1);
+                s->changes++;
+            }
+        } else if (c == 'r' || c == 'R') {
+            stim_token(s, &tok, &len);
+        } else if (c == '0' || c == '1' || c == 'x' || c == 'X' || c == 'z' || c == 'Z') {
+            STIM_SIGNAL* sig = stim_find(s, stim_id_key(tok + 1, len - 1));
+            if (sig) {
+                stim_apply(sig, tok, 1);
+                s->changes++;
+            }
+        }
+    }
+    signal_gather_run();
+    if (s->pos - s->released >= STIM_RELEASE_CHUNK) {
+        size_t end = s->pos & ~(size_t)(STIM_RELEASE_CHUNK - 1);
+        madvise((void*)(s->map + s->released), end - s->released, MADV_DONTNEED);
+        s->released = end;
+    }
+}
+
+/*
+ * stimulus_close
+ * 作用：解除文件映射并释放订阅表；未打开时无操作。
+ */
+void stimulus_close(STIMULUS* s) {
+    if (s->map)
+        munmap((void*)s->map, s->size);
+    free(s->signals);
+    free(s->slots);
+    free(s->words);
+    memset(s, 0, sizeof(*s));
+}
@@ -0,0 +1,190 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/timer_sched.h"
+#include "../include/color.h"
+
+// 堆中 a 是否排在 b 之前：先到期的在前，同时到期按 id 从小到大（与逐个 tick 定时器的顺序一致）
+static int timer_before(const TIMER_SCHED* s, uint32_t a, uint32_t b) {
+    const TIMER* x = &s->timers[a];
+    const TIMER* y = &s->timers[b];
+    return x->deadline != y->deadline ? x->deadline < y->deadline : a < b;
+}
+
+static void timer_heap_place(TIMER_SCHED* s, uint32_t slot, uint32_t id) {
+    s->heap[slot] = id;
+    s->timers[id].slot = slot;
+}
+
+static void timer_heap_up(TIMER_SCHED* s, uint32_t slot) {
+    uint32_t id = s->heap[slot];
+    while (slot > 0 && timer_before(s, id, s->heap[(slot - 1) / 2])) {
+        timer_heap_place(s, slot, s->heap[(slot - 1) / 2]);
+        slot = (slot - 1) / 2;
+    }
+    timer_heap_place(s, slot, id);
+}
+
+static void timer_heap_down(TIMER_SCHED* s, uint32_t slot) {
+    uint32_t id = s->heap[slot];
+    for (;;) {
+        uint32_t c = 2 * slot + 1;
+        if (c >= s->nheap)
+            break;
+        if (c + 1 < s->nheap && timer_before(s, s->heap[c + 1], s->heap[c]))
+            c++;
+        if (!timer_before(s, s->heap[c], id))
+            break;
+        timer_heap_place(s, slot, s->heap[c]);
+        slot = c;
+    }
+    timer_heap_place(s, slot, id);
+}
+
+static void timer_heap_top(TIMER_SCHED* s) {
+    s->next = s->nheap ? s->timers[s->heap[0]].deadline : UINT64_MAX;
+}
+
+/*
+ * timer_schedule
+ * 作用：按计数起点与阈值重新计算使能定时器的到期时间，并放入（或调整在）堆中的位置。
+ * 行为：到期时间为 now 起第一次计数达到阈值的 tick，即 max(first, base + threshold)，
+ *       first 为最早可以 tick 的时间（本条指令或下一条指令）。
+ */
+static void timer_schedule(TIMER_SCHED* s, uint32_t id, uint64_t first) {
+    TIMER* t = &s->timers[id];
+    uint64_t old = t->deadline;
+    t->deadline = t->base + t->threshold > first ? t->base + t->threshold : first;
+    if (!t->enabled) {
+        t->enabled = 1;
+        timer_heap_place(s, s->nheap++, id);
+        timer_heap_up(s, t->slot);
+    } else if (t->deadline < old) {
+        timer_heap_up(s, t->slot);
+    } else {
+        timer_heap_down(s, t->slot);
+    }
+    timer_heap_top(s);
+}
+
+static void timer_unschedule(TIMER_SCHED* s, uint32_t id) {
+    TIMER* t = &s->timers[id];
+    uint32_t slot = t->slot;
+    t->enabled = 0;
+    if (--s->nheap != slot) {
+        timer_heap_place(s, slot, s->heap[s->nheap]);
+        timer_heap_up(s, slot);
+        timer_heap_down(s, s->timers[s->heap[slot]].slot);
+    }
+    timer_heap_top(s);
+}
+
+/*
+ * timer_sched_init
+ * 作用：建立 count 个定时器（均为禁用、计数 0、没有目标），cpu_init 调用。
+ * 返回：成功返回1，内存不足返回0。
+ */
+int timer_sched_init(TIMER_SCHED* s, uint32_t count) {
+    memset(s, 0, sizeof(*s));
+    s->next = UINT64_MAX;
+    s->timers = (TIMER*)calloc(count ? count : 1, sizeof(TIMER));
+    s->heap = (uint32_t*)calloc(count ? count : 1, sizeof(uint32_t));
+    if (!s->timers || !s->heap) {
+        fprintf(stderr, "%s[timer] out of memory, %u timers%s\n", ANSI_RED, count, ANSI_RESET);
+        timer_sched_free(s);
+        return 0;
+    }
+    s->count = count;
+    return 1;
+}
+
+/*
+ * timer_sched_free
+ * 作用：释放定时器与堆。
+ */
+void timer_sched_free(TIMER_SCHED* s) {
+    free(s->timers);
+    free(s->heap);
+    memset(s, 0, sizeof(*s));
+    s->next = UINT64_MAX;
+}
+
+/*
+ * timer_sched_reset / timer_sched_enable / timer_sched_disable / timer_sched_config
+ * 作用：第 now 条指令执行 timer_set reset/enable/disable/cfg_enable。
+ * 行为：
+ *   - reset 清零计数，使能时本条指令的 tick 之后计数为 1；
+ *   - enable 从冻结的计数继续，本条指令即 tick；disable 冻结本条指令之前的计数，本条指令不再 tick；
+ *   - config 清零计数、设置阈值与目标 PC 并使能；
+ *   - 使能的定时器重新计算到期时间（计数已达到阈值时本条指令的 tick 即到期）。
+ */
+void timer_sched_reset(TIMER_SCHED* s, uint32_t id, uint64_t now) {
+    TIMER* t = &s->timers[id];
+    if (!t->enabled) {
+        t->base = 0;
+        return;
+    }
+    t->base = now - 1;
+    timer_schedule(s, id, now);
+}
+
+void timer_sched_enable(TIMER_SCHED* s, uint32_t id, uint64_t now) {
+    TIMER* t = &s->timers[id];
+    if (t->enabled)
+        return;
+    t->base = now - 1 - t->base;
+    timer_schedule(s, id, now);
+}
+
+void timer_sched_disable(TIMER_SCHED* s, uint32_t id, uint64_t now) {
+    TIMER* t = &s->timers[id];
+    if (!t->enabled)
+        return;
+    t->base = now - 1 - t->base;
+    timer_unschedule(s, id);
+}
+
+void timer_sched_config(TIMER_SCHED* s, uint32_t id, uint64_t now, uint64_t threshold, uint32_t target_pc) {
+    TIMER* t = &s->timers[id];
+    t->threshold = threshold;
+    t->target_pc = target_pc;
+    t->base = now - 1;
+    timer_schedule(s, id, now);
+}
+
+/*
+ * timer_sched_restore
+ * 作用：直接设定第 now 条指令 tick 之后的使能状态与计数（按轨迹记录重建定时器状态时使用）。
+ */
+void timer_sched_restore(TIMER_SCHED* s, uint32_t id, uint64_t now, int enabled, uint64_t value) {
+    TIMER* t = &s->timers[id];
+    if (!enabled) {
+        if (t->enabled)
+            timer_unschedule(s, id);
+        t->base = value;
+        return;
+    }
+    t->base = now - value;
+    timer_schedule(s, id, now + 1);
+}
+
+/*
+ * timer_sched_pop
+ * 作用：取出第 now 条指令 tick 时到期的一个定时器。
+ * 行为：
+ *   - 堆顶到期时间不晚于 now 时弹出，计数清零并按阈值排入下一次到期（至少在下一条指令）；
+ *   - 同一 tick 有多个定时器到期时按 id 从小到大依次返回，每个定时器每次 tick 至多返回一次。
+ * 返回：到期的定时器 id；没有到期的定时器返回 -1。
+ * 示例：
+ *   cfg_enable timer0 threshold=3 在第 10 条指令 => 第 12、15、18... 条指令 tick 时返回 0
+ */
+int timer_sched_pop(TIMER_SCHED* s, uint64_t now) {
+    if (!timer_sched_due(s, now))
+        return -1;
+    uint32_t id = s->heap[0];
+    TIMER* t = &s->timers[id];
+    t->base = now;
+    timer_schedule(s, id, now + 1);
+    return (int)id;
+}
@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../include/trace.h"
+#include "../include/cpu.h"
+#include "../include/color.h"
+
+// 当前打开的轨迹：assert 失败（SIGABRT）或被中断/终止时刷新已缓冲的记录，便于分析失败的运行
+static TRACE* trace_active;
+
+static int write_all(int fd, const void* data, size_t bytes) {
+    const char* p = data;
+    while (bytes > 0) {
+        ssize_t n = write(fd, p, bytes);
+        if (n <= 0)
+            return 0;
+        p += n;
+        bytes -= (size_t)n;
+    }
+    return 1;
+}
+
+static const int trace_flush_signals[] = { SIGABRT, SIGINT, SIGTERM };
+static struct sigaction trace_prev_actions[sizeof(trace_flush_signals) / sizeof(trace_flush_signals[0])];
+
+// 刷新后恢复注册前的处理（默认或异步日志的排空）并重新触发
+static void trace_signal_handler(int sig) {
+    if (trace_active && trace_active->count)
+        write_all(trace_active->fd, trace_active->buf, (size_t)trace_active->count * sizeof(TraceRecord));
+    for (size_t i = 0; i < sizeof(trace_flush_signals) / sizeof(trace_flush_signals[0]); i++)
+        if (trace_flush_signals[i] == sig)
+            sigaction(sig, &trace_prev_actions[i], NULL);
+    raise(sig);
+}
+
+/*
+ * trace_open
+ * 作用：打开二进制轨迹文件（--trace-file）。
+ * 行为：
+ *   - 创建/截断文件并写入文件头（记录大小、镜像路径）；
+ *   - 分配记录缓冲区，注册 SIGABRT/SIGINT/SIGTERM 时的刷新。
+ * 返回：成功返回1，失败打印错误并返回0。
+ */
+int trace_open(TRACE* t, const char* path, const char* image) {
+    memset(t, 0, sizeof(*t));
+    t->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (t->fd < 0) {
+        fprintf(stderr, "%s[trace] open failed: %s%s\n", ANSI_RED, path, ANSI_RESET);
+        return 0;
+    }
+    t->buf = malloc((size_t)TRACE_BUF_RECORDS * sizeof(TraceRecord));
+    if (!t->buf) {
+        fprintf(stderr, "%s[trace] out of memory%s\n", ANSI_RED, ANSI_RESET);
+        close(t->fd);
+        return 0;
+    }
+
+    TraceHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, TRACE_MAGIC, sizeof(h.magic));
+    h.version = TRACE_VERSION;
+    h.record_size = sizeof(TraceRecord);
+    strncpy(h.image, image, sizeof(h.image) - 1);
+    if (!write_all(t->fd, &h, sizeof(h))) {
+        fprintf(stderr, "%s[trace] write failed: %s%s\n", ANSI_RED, path, ANSI_RESET);
+        free(t->buf);
+        close(t->fd);
+        return 0;
+    }
+
+    t->enabled = 1;
+    trace_active = t;
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = trace_signal_handler;
+    for (size_t i = 0; i < sizeof(trace_flush_signals) / sizeof(trace_flush_signals[0]); i++)
+        sigaction(trace_flush_signals[i], &sa, &trace_prev_actions[i]);
+    return 1;
+}
+
+/*
+ * trace_flush
+ * 作用：将缓冲区中的记录整块写入文件并清空缓冲区。
+ */
+void trace_flush(TRACE* t) {
+    if (!t->count)
+        return;
+    if (!write_all(t->fd, t->buf, (size_t)t->count * sizeof(TraceRecord)))
+        fprintf(stderr, "%s[trace] write failed, %u records dropped%s\n", ANSI_RED, t->count, ANSI_RESET);
+    t->count = 0;
+}
+
+/*
+ * trace_close
+ * 作用：刷新剩余记录并关闭轨迹文件；未打开时无操作。
+ */
+void trace_close(TRACE* t) {
+    if (!t->enabled)
+        return;
+    trace_flush(t);
+    close(t->fd);
+    free(t->buf);
+    if (trace_active == t) {
+        trace_active = NULL;
+        for (size_t i = 0; i < sizeof(trace_flush_signals) / sizeof(trace_flush_signals[0]); i++)
+            sigaction(trace_flush_signals[i], &trace_prev_actions[i], NULL);
+    }
+    t->enabled = 0;
+}
+
+/*
+ * trace_dest_reg
+ * 作用：返回指令写入的寄存器（TRACE_REG_*），记录与解码两端共用。
+ * 示例：
+ *   trace_dest_reg(add r1 = r1 + r2) => 1
+ *   trace_dest_reg(bl 8)             => TRACE_REG_RET
+ *   trace_dest_reg(send ...)         => TRACE_REG_NONE
+ */
+uint8_t trace_dest_reg(const DecodedInst* d) {
+    switch (d->op) {
+        case INST_OP_MOVI: case INST_OP_MOV:
+        case INST_OP_ARITH_AND: case INST_OP_ARITH_OR: case INST_OP_ARITH_XOR:
+        case INST_OP_ARITH_REDU_AND: case INST_OP_ARITH_REDU_OR: case INST_OP_ARITH_REDU_XOR:
+        case INST_OP_ARITH_CONCAT: case INST_OP_ARITH_ISUNKNOW:
+        case INST_OP_ARITH_ADD: case INST_OP_ARITH_SUB:
+        case INST_OP_BIT_SLICE: case INST_OP_LOAD:
+        case INST_OP_EDGE_P: case INST_OP_EDGE_N: case INST_OP_EDGE_T: case INST_OP_EDGE_L:
+        case INST_OP_EDGE_H: case INST_OP_EDGE_S: case INST_OP_EDGE_X: case INST_OP_EDGE_UNKNOWN:
+            return d->rd;
+        case INST_OP_BL: case INST_OP_RET:
+            return TRACE_REG_RET;
+        default:
+            return TRACE_REG_NONE;
+    }
+}
+
+/*
+ * trace_record
+ * 作用：记录一条已执行指令（执行与定时器 tick 之后调用，取代逐条的文本打印）。
+ * 行为：
+ *   - 保存 PC、原始指令、写入的寄存器及新值、执行后的 PC 与定时器状态；
+ *   - 缓冲区写满时整块写入文件。
+ */
+void trace_record(TRACE* t, const CPU* cpu, const DecodedInst* d, uint32_t pc) {
+    TraceRecord* r = &t->buf[t->count];
+    r->raw = d->raw;
+    r->pc = pc;
+    r->next_pc = cpu->pc;
+    r->length = d->length;
+    r->reg = trace_dest_reg(d);
+    r->value = r->reg == TRACE_REG_RET ? cpu->ret_reg : r->reg < 16 ? cpu->regs[r->reg] : 0;
+    r->flags = (cpu->timers.timers[0].enabled ? TRACE_F_T0_EN : 0) | (cpu->timers.timers[1].enabled ? TRACE_F_T1_EN : 0);
+    r->reserved = 0;
+    for (int id = 0; id < 2; id++)
+        r->timer[id] = timer_sched_value(&cpu->timers, id, cpu->inst_retired);
+    t->total++;
+    if (++t->count == TRACE_BUF_RECORDS)
+        trace_flush(t);
+}
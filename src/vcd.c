@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "../include/vcd.h"
+#include "../include/cpu.h"
+#include "../include/color.h"
+
+static void vcd_flush(VCD* v) {
+    if (v->used && fwrite(v->buf, 1, v->used, v->fp) != v->used)
+        fprintf(stderr, "%s[vcd] write failed%s\n", ANSI_RED, ANSI_RESET);
+    v->used = 0;
+}
+
+// 单条变化最长：'b' + 64 位 + ' ' + 标识符 + '\n'
+#define VCD_LINE_MAX 80
+
+// 值变化："b<二进制，去掉前导 0> <id>"；标识符为 '!' 起的单个可打印字符
+static void vcd_put_value(VCD* v, int sig, uint64_t value) {
+    if (v->used + VCD_LINE_MAX > VCD_BUF_SIZE)
+        vcd_flush(v);
+    char* p = v->buf + v->used;
+    *p++ = 'b';
+    int bit = 63 - (value ? __builtin_clzll(value) : 63);
+    for (; bit >= 0; bit--)
+        *p++ = (char)('0' + ((value >> bit) & 1));
+    *p++ = ' ';
+    *p++ = (char)('!' + sig);
+    *p++ = '\n';
+    v->used = (size_t)(p - v->buf);
+}
+
+static void vcd_put_time(VCD* v, uint64_t cycle) {
+    if (v->used + VCD_LINE_MAX > VCD_BUF_SIZE)
+        vcd_flush(v);
+    v->used += (size_t)snprintf(v->buf + v->used, VCD_LINE_MAX, "#%" PRIu64 "\n", cycle);
+}
+
+/*
+ * vcd_open
+ * 作用：创建 VCD 文件（--vcd），写入变量定义与初始值（#0 $dumpvars）。
+ * 返回：成功返回1，失败打印错误并返回0。
+ */
+int vcd_open(VCD* v, const char* path, const CPU* cpu) {
+    memset(v, 0, sizeof(*v));
+    v->fp = fopen(path, "w");
+    v->buf = malloc(VCD_BUF_SIZE);
+    if (!v->fp || !v->buf) {
+        fprintf(stderr, "%s[vcd] open failed: %s%s\n", ANSI_RED, path, ANSI_RESET);
+        if (v->fp)
+            fclose(v->fp);
+        free(v->buf);
+        return 0;
+    }
+
+    fprintf(v->fp, "$comment tsl_cpu_emulator: one time unit per executed instruction $end\n");
+    fprintf(v->fp, "$timescale 1ns $end\n");
+    fprintf(v->fp, "$scope module tsl_cpu $end\n");
+    for (int i = 0; i < REG_SIG_COUNT; i++)
+        fprintf(v->fp, "$var wire %u %c %s $end\n", reg_signal_widths[i], '!' + i, reg_signal_names[i]);
+    fprintf(v->fp, "$upscope $end\n$enddefinitions $end\n");
+
+    uint64_t cur[REG_SIG_COUNT];
+    reg_delta_sample(&v->delta, cpu, cur);
+    vcd_put_time(v, 0);
+    v->used += (size_t)snprintf(v->buf + v->used, VCD_LINE_MAX, "$dumpvars\n");
+    for (int i = 0; i < REG_SIG_COUNT; i++)
+        vcd_put_value(v, i, cur[i]);
+    v->used += (size_t)snprintf(v->buf + v->used, VCD_LINE_MAX, "$end\n");
+
+    v->enabled = 1;
+    return 1;
+}
+
+/*
+ * vcd_sample
+ * 作用：每条指令退休后调用，只写出与上次相比变化的值，时间戳为已执行指令数。
+ */
+void vcd_sample(VCD* v, const CPU* cpu) {
+    uint64_t cur[REG_SIG_COUNT];
+    uint32_t changed = reg_delta_sample(&v->delta, cpu, cur);
+    if (!changed)
+        return;
+    vcd_put_time(v, cpu->inst_retired);
+    for (; changed; changed &= changed - 1) {
+        int i = __builtin_ctz(changed);
+        vcd_put_value(v, i, cur[i]);
+    }
+}
+
+/*
+ * vcd_close
+ * 作用：写出剩余内容并关闭文件；未打开时无操作。
+ */
+void vcd_close(VCD* v) {
+    if (!v->enabled)
+        return;
+    vcd_flush(v);
+    fclose(v->fp);
+    free(v->buf);
+    v->enabled = 0;
+}
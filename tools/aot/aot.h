@@ -0,0 +1,20 @@
+#ifndef AOT_H
+#define AOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cpu.h"
+#include "log.h"
+
+//=====================================================================================
+//   AOT 生成代码与运行时 main（aot_main.c）之间的接口，由 tsl_aot 生成的 .c 定义
+//=====================================================================================
+extern const uint8_t aot_image[];       // 翻译时的程序镜像，运行时校验加载的 .bin 与之一致
+extern const size_t  aot_image_size;
+extern const char    aot_image_path[];  // 翻译时的 .bin 路径，未指定命令行参数时使用
+extern const LOG_LEVEL aot_log_level;   // 翻译时固定的日志级别（tsl_aot --log-level）
+extern const uint64_t aot_dram_size;    // 翻译时的 DRAM 大小（tsl_aot --dram-size），运行时 --dram-size 的默认值
+
+void aot_run(CPU* cpu);
+
+#endif
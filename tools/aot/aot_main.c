@@ -0,0 +1,111 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+
+#include "cpu.h"
+#include "color.h"
+#include "loader.h"
+#include "log.h"
+#include "aot.h"
+
+/*
+ * main（AOT 可执行文件）
+ * 作用：与 emulator 相同的启动流程，主循环换成 tsl_aot 生成的 aot_run。
+ * 行为：
+ *   - 解析 --log-level、--dump-image、--dram-size（同 emulator）；日志级别默认为翻译时的级别，
+ *     生成代码只含该级别的逐条输出，指定其它级别时报错，须以 tsl_aot --log-level 重新翻译；
+ *     DRAM 大小默认为翻译时的大小，只用于建立 DRAM，镜像之外的 PC 由解释器单步执行；
+ *   - 加载 .bin（默认为翻译时的路径），信息 DB 目录同样取自该路径；
+ *   - 加载内容须与翻译时的镜像一致，否则报错退出；
+ *   - 建立解码缓存（生成代码未覆盖的 PC 退回解释器单步执行），执行到 PC 返回 0；
+ *   - 低于 full 级别时打印结束汇总。
+ * 示例：
+ *   examples/test_timer/test_timer_aot => 输出与 ./emulator examples/test_timer/test_timer.bin 一致
+ */
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char* argv[]) {
+    static const struct option long_opts[] = {
+        { "log-level", required_argument, NULL, 'l' },
+        { "dump-image", no_argument,      NULL, 'm' },
+        { "dram-size",  required_argument, NULL, 's' },
+        { NULL, 0, NULL, 0 }
+    };
+    LOG_LEVEL level = aot_log_level;
+    uint64_t dram_size = aot_dram_size;
+    int dump_image = 0;
+    int opt;
+    while ((opt = getopt_long(argc, argv, "", long_opts, NULL)) != -1) {
+        if (opt == 'm') {
+            dump_image = 1;
+            continue;
+        }
+        int ok = opt == 'l' ? log_level_parse(optarg, &level)
+               : opt == 's' ? dram_parse_size(optarg, &dram_size) : 0;
+        if (!ok) {
+            log_printf("%sUsage: %s [--log-level=quiet|summary|trace|full] [--dump-image] [--dram-size=N[K|M]|max] [filename.bin]%s\n", ANSI_RED, argv[0], ANSI_RESET);
+            exit(1);
+        }
+    }
+    if (level != aot_log_level) {
+        fprintf(stderr, "%s[aot] translated for --log-level=%s, re-run tsl_aot --log-level=%s%s\n",
+                ANSI_RED, log_level_name(aot_log_level), log_level_name(level), ANSI_RESET);
+        exit(1);
+    }
+    if (argc - optind > 1) {
+        log_printf("%sUsage: %s [--log-level=quiet|summary|trace|full] [--dump-image] [--dram-size=N[K|M]|max] [filename.bin]%s\n", ANSI_RED, argv[0], ANSI_RESET);
+        exit(1);
+    }
+    set_log_level(level);
+    const char* filename = optind < argc ? argv[optind] : aot_image_path;
+
+    if (LOG_ENABLED(LOG_SUMMARY)) {
+        log_printf("\n%s==================================================================================%s\n", ANSI_BOLD_WHITE, ANSI_RESET);
+        log_printf("%s                          Emulator exec start!                        %s\n", ANSI_BOLD_GREEN, ANSI_RESET);
+        log_printf("%s==================================================================================%s\n", ANSI_BOLD_WHITE, ANSI_RESET);
+    }
+
+    set_info_base(filename);
+
+    struct CPU cpu;
+    if (!cpu_init(&cpu, dram_size)) {
+        fprintf(stderr, "%s[cpu] init failed%s\n", ANSI_RED, ANSI_RESET);
+        cpu_cleanup(&cpu);
+        return 1;
+    }
+
+    size_t image_size = read_file(&cpu, filename, dump_image);
+    if (image_size == 0) {
+        cpu_cleanup(&cpu);
+        return 0;
+    }
+    if (image_size != aot_image_size || memcmp(cpu.bus.dram.image, aot_image, image_size) != 0) {
+        fprintf(stderr, "%s[aot] %s differs from the image this binary was translated from (%s)%s\n", ANSI_RED, filename, aot_image_path, ANSI_RESET);
+        cpu_cleanup(&cpu);
+        return 1;
+    }
+
+    cpu_init_caches(&cpu, image_size);
+
+    double start = now_seconds();
+    aot_run(&cpu);
+    if (!LOG_ENABLED(LOG_FULL))
+        cpu_print_summary(&cpu, now_seconds() - start);
+
+    cpu_cleanup(&cpu);
+
+    if (LOG_ENABLED(LOG_SUMMARY)) {
+        log_printf("\n%s==================================================================================%s\n", ANSI_BOLD_WHITE, ANSI_RESET);
+        log_printf("%s                          Emulator exec successfully!                        %s\n", ANSI_BOLD_GREEN, ANSI_RESET);
+        log_printf("%s==================================================================================%s\n", ANSI_BOLD_WHITE, ANSI_RESET);
+    }
+
+    return 0;
+}
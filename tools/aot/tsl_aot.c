@@ -0,0 +1,509 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <getopt.h>
+
+#include "cpu.h"
+#include "color.h"
+#include "log.h"
+
+/*
+ * tsl_aot：.bin 程序镜像 → C 翻译单元
+ *
+ * 从入口 PC 0 出发静态遍历 DRAM 中的镜像（顺序执行、跳转目标、bl 返回点、timer_set 目标），
+ * 可达指令按块生成本机函数（块内顺序执行，块间经 PC 入口表分派），指令语义按对应 exec_* 内联展开。
+ * 日志级别在翻译时固定（AOT_LOG_LEVEL），逐条指令的反汇编与寄存器打印只为该级别生成，输出经 log_printf/log_write。
+ * DRAM 大小同 emulator 的 --dram-size（默认 DRAM_DEFAULT_SIZE），记入生成代码作为运行时的默认值；
+ * 它只决定镜像截断，遍历与生成的表只覆盖镜像本身，不随 DRAM 大小增长。
+ * 生成的 .c 与 tools/aot/aot_main.c、src/ 下的运行时（info_db.c 的信息表与定时器等）一起编译。
+ *
+ * 用法：
+ *   tsl_aot [--log-level=quiet|summary|trace|full] [--dram-size=N[K|M]|max] <image.bin> <out.c>
+ */
+
+typedef struct AOT_PROGRAM {
+    CPU cpu;                        // 借用解码缓存做静态解码
+    uint64_t size;                  // 遍历范围字节数（加载的镜像）
+    const DecodedInst** insts;      // 每个 PC 的解码结果，不可达或无法解码为 NULL
+    uint8_t* reach;                 // 1：可达
+    uint8_t* leader;                // 1：块入口（入口 PC、静态跳转目标、控制转移之后的指令）
+} AotProgram;
+
+static uint8_t* read_image(const char* path, uint64_t* size) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "%s[aot] unable to open %s%s\n", ANSI_RED, path, ANSI_RESET);
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (len <= 0) {
+        fprintf(stderr, "%s[aot] %s is empty%s\n", ANSI_RED, path, ANSI_RESET);
+        fclose(f);
+        return NULL;
+    }
+    uint8_t* buf = (uint8_t*)malloc((size_t)len);
+    if (!buf || fread(buf, 1, (size_t)len, f) != (size_t)len) {
+        fprintf(stderr, "%s[aot] read error on %s%s\n", ANSI_RED, path, ANSI_RESET);
+        free(buf);
+        fclose(f);
+        return NULL;
+    }
+    fclose(f);
+    *size = (uint64_t)len;
+    return buf;
+}
+
+// 修改 PC 的指令：不落入下一条
+static int is_control(uint16_t op) {
+    return op == INST_OP_JMP || op == INST_OP_BL || op == INST_OP_RET ||
+           (op >= INST_OP_JMPC_EQ && op <= INST_OP_JMPC_NEG);
+}
+
+// 读信号值的指令：load 取值、send 按信号值格式化（开始前须采样信号存储并推进波形激励）
+static int reads_signals(uint16_t op) {
+    return op == INST_OP_LOAD || (op >= INST_OP_SEND_DISPLAY && op <= INST_OP_SEND_UNKNOWN);
+}
+
+// 读边沿采样的指令：比较本周期与前一周期的采样
+static int reads_edges(uint16_t op) {
+    return (op >= INST_OP_EDGE_P && op <= INST_OP_EDGE_S) || op == INST_OP_JMPC_POS || op == INST_OP_JMPC_NEG;
+}
+
+// 交给解释器单步执行的指令：非法编码与错误路径，输出与断言保持原样
+static int needs_interp(const DecodedInst* d) {
+    switch (d->op) {
+        case INST_OP_INVALID: case INST_OP_SEND_UNKNOWN: case INST_OP_EDGE_UNKNOWN:
+        case INST_OP_JMPC_UNKNOWN: case INST_OP_ARITH_UNKNOWN:
+        case INST_OP_MOVI_INVALID: case INST_OP_TIMER_INVALID:
+            return 1;
+        case INST_OP_BIT_SLICE:
+            return d->lo > d->hi;
+        default:
+            return d->length == 0;  // 长度非法由 cpu_execute_decoded 报错
+    }
+}
+
+// 指令的静态跳转目标（jmp/bl/jmpc/timer_set cfg_enable），以 32 位 PC 回绕计算
+static uint32_t static_target(uint32_t pc, const DecodedInst* d) {
+    return pc + d->length + (uint32_t)d->offset;
+}
+
+/*
+ * aot_walk
+ * 作用：从入口 PC 开始的可达性遍历。
+ * 行为：
+ *   - 顺序后继、jmp/jmpc/bl 目标、bl 返回点、timer_set cfg_enable 目标均入队；
+ *   - 只遍历镜像范围：镜像之后的零字节（解码为 jmpc r0==r0 +0）不生成块，运行时执行到那里时由解释器单步；
+ *   - ret 目标在运行时才确定，由生成代码的 PC 分派处理；
+ *   - 无法解码的 PC 也标记可达，生成代码在该处退回解释器报错。
+ */
+static void aot_walk(AotProgram* p) {
+    uint32_t* queue = (uint32_t*)malloc(p->size * sizeof(uint32_t));
+    uint64_t head = 0, tail = 0;
+
+#define AOT_PUSH(pc, is_leader) do {                            \
+        uint64_t off_ = (uint64_t)(pc) - DRAM_BASE;             \
+        if (off_ < p->size) {                                   \
+            if (is_leader) p->leader[off_] = 1;                 \
+            if (!p->reach[off_]) {                              \
+                p->reach[off_] = 1;                             \
+                queue[tail++] = (uint32_t)(pc);                 \
+            }                                                   \
+        }                                                       \
+    } while (0)
+
+    AOT_PUSH(DRAM_BASE, 1);
+    while (head < tail) {
+        uint32_t pc = queue[head++];
+        const DecodedInst* d = cpu_decode_at(&p->cpu, pc);
+        p->insts[pc - DRAM_BASE] = d;
+        if (!d)
+            continue;
+        if (d->op == INST_OP_JMP || d->op == INST_OP_BL ||
+            (d->op >= INST_OP_JMPC_EQ && d->op <= INST_OP_JMPC_NEG) ||
+            d->op == INST_OP_TIMER_CFG_ENABLE)
+            AOT_PUSH(static_target(pc, d), 1);
+        if (d->op != INST_OP_JMP && d->op != INST_OP_RET)
+            AOT_PUSH(pc + d->length, is_control(d->op) || needs_interp(d));
+    }
+#undef AOT_PUSH
+    free(queue);
+}
+
+/*
+ * emit_semantics
+ * 作用：生成一条指令的执行语义，与 src/cpu.c 中对应 exec_* 一致。
+ */
+static void emit_semantics(FILE* out, const DecodedInst* d) {
+    static const char* cmp_ops[] = { "==", "!=", ">", "<", ">=", "<=" };
+    static const char* arith_ops[] = { "&", "|", "^" };
+#define TSL_EDGE_CLASS_NAME(name) "EDGE_CLASS_" #name,
+    static const char* edge_classes[] = { TSL_EDGE_CLASSES(TSL_EDGE_CLASS_NAME) };
+#undef TSL_EDGE_CLASS_NAME
+
+    switch (d->op) {
+        case INST_OP_MOVI:
+            fprintf(out, "    cpu->regs[%u] = 0x%xu;\n", d->rd, d->imm);
+            break;
+        case INST_OP_MOV:
+            fprintf(out, "    cpu->regs[%u] = cpu->regs[%u];\n", d->rd, d->rs1);
+            break;
+        case INST_OP_TIMER_RESET:
+            fprintf(out, "    timer_sched_reset(&cpu->timers, %u, cpu->inst_retired);\n", d->rd);
+            break;
+        case INST_OP_TIMER_DISABLE:
+            fprintf(out, "    timer_sched_disable(&cpu->timers, %u, cpu->inst_retired);\n", d->rd);
+            break;
+        case INST_OP_TIMER_ENABLE:
+            fprintf(out, "    timer_sched_enable(&cpu->timers, %u, cpu->inst_retired);\n", d->rd);
+            break;
+        case INST_OP_TIMER_CFG_ENABLE:
+            fprintf(out, "    timer_sched_config(&cpu->timers, %u, cpu->inst_retired, %uu, cpu->pc + %d);\n", d->rd, d->imm, d->offset);
+            break;
+        case INST_OP_JMPC_EQ: case INST_OP_JMPC_NE: case INST_OP_JMPC_GT:
+        case INST_OP_JMPC_LT: case INST_OP_JMPC_GE: case INST_OP_JMPC_LE:
+            fprintf(out, "    if (cpu->regs[%u] %s cpu->regs[%u]) cpu->pc += %d;\n",
+                    d->rs1, cmp_ops[d->op - INST_OP_JMPC_EQ], d->rs2, d->offset);
+            break;
+        case INST_OP_JMPC_POS:
+            fprintf(out, "    if (EDGE(EDGE_CLASS_P, %u)) cpu->pc += %d;\n", d->rs1, d->offset);
+            break;
+        case INST_OP_JMPC_NEG:
+            fprintf(out, "    if (EDGE(EDGE_CLASS_N, %u)) cpu->pc += %d;\n", d->rs1, d->offset);
+            break;
+        case INST_OP_ARITH_AND: case INST_OP_ARITH_OR: case INST_OP_ARITH_XOR:
+            fprintf(out, "    cpu->regs[%u] = cpu->regs[%u] %s cpu->regs[%u];\n",
+                    d->rd, d->rs1, arith_ops[d->op - INST_OP_ARITH_AND], d->rs2);
+            break;
+        case INST_OP_ARITH_ADD:
+            fprintf(out, "    cpu->regs[%u] = cpu->regs[%u] + cpu->regs[%u];\n", d->rd, d->rs1, d->rs2);
+            break;
+        case INST_OP_ARITH_SUB:
+            fprintf(out, "    cpu->regs[%u] = cpu->regs[%u] - cpu->regs[%u];\n", d->rd, d->rs1, d->rs2);
+            break;
+        case INST_OP_ARITH_REDU_AND:
+            fprintf(out, "    cpu->regs[%u] = cpu->regs[%u] == 0xFFFFFFFFu;\n", d->rd, d->rs1);
+            break;
+        case INST_OP_ARITH_REDU_OR:
+            fprintf(out, "    cpu->regs[%u] = cpu->regs[%u] != 0;\n", d->rd, d->rs1);
+            break;
+        case INST_OP_ARITH_REDU_XOR:
+            fprintf(out, "    cpu->regs[%u] = __builtin_parity(cpu->regs[%u]);\n", d->rd, d->rs1);
+            break;
+        case INST_OP_ARITH_CONCAT:
+            fprintf(out, "    cpu->regs[%u] = ((cpu->regs[%u] & 0xFFFF) << 16) | (cpu->regs[%u] & 0xFFFF);\n", d->rd, d->rs1, d->rs2);
+            break;
+        case INST_OP_ARITH_ISUNKNOW:
+            fprintf(out, "    cpu->regs[%u] = 1;\n", d->rd);
+            break;
+        case INST_OP_BIT_SLICE: {
+            uint32_t mask = ((1U << (d->hi - d->lo + 1)) - 1);
+            fprintf(out, "    cpu->regs[%u] = (cpu->regs[%u] >> %u) & 0x%xu;\n", d->rd, d->rs1, d->lo, mask);
+            break;
+        }
+        case INST_OP_LOAD:
+            fprintf(out, "    { uint32_t val = cpu_load_signal(cpu, 0x%xu);\n", d->imm);
+            fprintf(out, "      cpu->regs[%u] = val;\n", d->rd);
+            fprintf(out, "      if (AOT_LOG_LEVEL >= LOG_TRACE)\n");
+            fprintf(out, "        log_printf(\"%%sGet signal var from addr[0x%%x] = 0x%%x%%s\\n\", ANSI_BOLD_GREEN, 0x%xu, val, ANSI_RESET); }\n", d->imm);
+            break;
+        case INST_OP_TRIGGER_POS:
+            fprintf(out, "    cpu->trigger_count++;\n");
+            fprintf(out, "    log_printf(\"%%sTrigger sample pos set %%u%%%%!%%s\\n\", ANSI_BOLD_GREEN, %uu, ANSI_RESET);\n", d->imm);
+            break;
+        case INST_OP_TRIGGER:
+            fprintf(out, "    cpu->trigger_count++;\n");
+            fprintf(out, "    log_printf(\"%%sTime stop! Start trigger signal sample!%%s\\n\", ANSI_BOLD_GREEN, ANSI_RESET);\n");
+            break;
+        case INST_OP_JMP:
+            fprintf(out, "    cpu->pc += %d;\n", d->offset);
+            break;
+        case INST_OP_BL:
+            fprintf(out, "    cpu->ret_reg = cpu->pc;\n");
+            fprintf(out, "    cpu->pc += %d;\n", d->offset);
+            break;
+        case INST_OP_RET:
+            fprintf(out, "    cpu->pc = cpu->ret_reg;\n");
+            fprintf(out, "    cpu->ret_reg = 0;\n");
+            break;
+        case INST_OP_DOMAIN_SET:
+            fprintf(out, "    aot_domain_set(cpu, %uu);\n", (uint8_t)d->imm);
+            break;
+        case INST_OP_SEND_DISPLAY: case INST_OP_SEND_EXEC:
+            fprintf(out, "    aot_send_print(cpu, 0x%xu, %uu);\n", d->func, d->imm);
+            break;
+        case INST_OP_EDGE_X:
+            fprintf(out, "    cpu->regs[%u] = 1;\n", d->rd);
+            break;
+        default: // EDGE_P..EDGE_S
+            fprintf(out, "    cpu->regs[%u] = EDGE(%s, %u);\n", d->rd, edge_classes[d->op - INST_OP_EDGE_P], d->rs1);
+            break;
+    }
+}
+
+static void emit_prologue(FILE* out, const char* image_path, LOG_LEVEL level, uint64_t dram_size) {
+    fprintf(out,
+        "/* Generated by tsl_aot --log-level=%s --dram-size=%lu from %s. Do not edit. */\n"
+        "#include <stdio.h>\n"
+        "#include <stdint.h>\n"
+        "#include <assert.h>\n"
+        "#include \"cpu.h\"\n"
+        "#include \"color.h\"\n"
+        "#include \"info_db.h\"\n"
+        "#include \"log.h\"\n"
+        "#include \"aot.h\"\n"
+        "\n"
+        "// 翻译时固定的日志级别，低于该级别的逐条输出不生成\n"
+        "#define AOT_LOG_LEVEL %d\n"
+        "const LOG_LEVEL aot_log_level = AOT_LOG_LEVEL;\n"
+        "// 翻译时的 DRAM 大小（--dram-size 的默认值）\n"
+        "#define AOT_DRAM_SIZE %luull\n"
+        "const uint64_t aot_dram_size = AOT_DRAM_SIZE;\n"
+        "\n"
+        "#define EDGE(c, r) signal_store_edge(&cpu->sig, (c), (r))\n"
+        "\n"
+        "// 与解释器相同的 tick/dump 顺序；定时器跳转时返回分派\n"
+        "static int aot_retire(CPU* cpu) {\n"
+        "    int jumped = timer_sched_due(&cpu->timers, cpu->inst_retired) && timer_tick_and_jump(cpu);\n"
+        "    if (AOT_LOG_LEVEL >= LOG_FULL)\n"
+        "        dump_registers(cpu);\n"
+        "    return jumped;\n"
+        "}\n"
+        "#define RETIRE() do { if (aot_retire(cpu)) return 1; } while (0)\n"
+        "\n"
+        "static void aot_send_print(CPU* cpu, uint8_t func, uint32_t db_id) {\n"
+        "    cpu->send_count++;\n"
+        "    size_t n;\n"
+        "    const char* line = builtin_send_line(db_id, func, &n);\n"
+        "    log_write(line, n);\n"
+        "}\n"
+        "\n"
+        "static void aot_domain_set(CPU* cpu, uint8_t offset) {\n"
+        "    cpu->domain = offset;\n"
+        "    char* info = get_domain_info(offset);\n"
+        "    if (info) {\n"
+        "        if (AOT_LOG_LEVEL >= LOG_SUMMARY)\n"
+        "            log_printf(\"%%sdomain(%%s)%%s\\n\", ANSI_BOLD_GREEN, info, ANSI_RESET);\n"
+        "    } else {\n"
+        "        fprintf(stderr, \"%%s[cpu][db] domain not found: %%u!%%s\\n\", ANSI_RED, offset, ANSI_RESET);\n"
+        "        assert(0);\n"
+        "    }\n"
+        "}\n"
+        "\n", log_level_name(level), (unsigned long)dram_size, image_path, (int)level, (unsigned long)dram_size);
+}
+
+static void emit_image(FILE* out, const uint8_t* image, uint64_t size, const char* image_path) {
+    fprintf(out, "const size_t aot_image_size = %lu;\n", (unsigned long)size);
+    fprintf(out, "const char aot_image_path[] = \"");
+    for (const char* c = image_path; *c; c++) {
+        if (*c == '"' || *c == '\\') fputc('\\', out);
+        fputc(*c, out);
+    }
+    fprintf(out, "\";\n");
+    fprintf(out, "const uint8_t aot_image[] = {");
+    for (uint64_t i = 0; i < size; i++)
+        fprintf(out, "%s0x%02x,", i % 16 == 0 ? "\n    " : " ", image[i]);
+    fprintf(out, "\n};\n\n");
+}
+
+static void emit_inst_table(FILE* out, const AotProgram* p) {
+    fprintf(out, "static const DecodedInst aot_insts[] = {\n");
+    for (uint64_t off = 0; off < p->size; off++) {
+        const DecodedInst* d = p->insts[off];
+        if (!d || needs_interp(d))
+            continue;
+        fprintf(out, "    { .raw = 0x%lxull, .op = %u, .valid = 1, .length = %u, .opcode = 0x%x, .func = 0x%x,"
+                     " .rd = %u, .rs1 = %u, .rs2 = %u, .hi = %u, .lo = %u, .offset = %d, .imm = 0x%xu }, /* %#.8lx */\n",
+                (unsigned long)d->raw, d->op, d->length, d->opcode, d->func,
+                d->rd, d->rs1, d->rs2, d->hi, d->lo, d->offset, d->imm, (unsigned long)(off + DRAM_BASE));
+    }
+    fprintf(out, "    { 0 }\n};\n\n");
+}
+
+// 指令开始前是否总要采样：读信号或边沿、修改定时器，或顺序后继为边沿类指令（不可知时按需要处理）
+static int needs_sample(const AotProgram* p, uint64_t off, const DecodedInst* d) {
+    if (reads_signals(d->op) || reads_edges(d->op) || (d->op >= INST_OP_TIMER_RESET && d->op <= INST_OP_TIMER_INVALID))
+        return 1;
+    if (is_control(d->op))
+        return 0;   // 控制转移不写 R0-R13，跳转目标处的采样按时间跳跃补齐
+    const DecodedInst* next = off + d->length < p->size ? p->insts[off + d->length] : NULL;
+    return !next || needs_interp(next) || reads_edges(next->op);
+}
+
+/*
+ * emit_blocks
+ * 作用：按块生成本机函数。
+ * 行为：
+ *   - 可达 PC 按地址顺序划分为块：块入口、控制转移之后或与上一条不连续时开始新块；
+ *   - 每条指令内联开始步骤：trace 及以上级别打印地址与反汇编，更新 PC 与已执行指令数；
+ *     读信号/边沿的指令、边沿类指令的前一条与 timer_set 前采样信号存储，其余指令只在定时器
+ *     本条到期（可能跳到边沿类指令）时采样，与线程化内核的规则一致（见 block_build）；
+ *   - 之后内联语义、tick 定时器，full 级别打印寄存器；
+ *   - 定时器跳转或块结束时返回1交回分派；
+ *   - 需要解释器处理的 PC（含长度非法）不生成函数，由分派退回单步执行。
+ */
+static void emit_blocks(FILE* out, const AotProgram* p, LOG_LEVEL level) {
+    uint32_t k = 0;
+    uint64_t open_next = UINT64_MAX;   // 当前打开块的顺序后继，UINT64_MAX 表示没有打开的块
+
+    for (uint64_t off = 0; off < p->size; off++) {
+        if (!p->reach[off])
+            continue;
+        uint32_t pc = (uint32_t)(off + DRAM_BASE);
+        const DecodedInst* d = p->insts[off];
+        int interp = !d || needs_interp(d);
+
+        if (open_next != UINT64_MAX && (open_next != pc || p->leader[off] || interp)) {
+            fprintf(out, "    return 1;\n}\n\n");
+            open_next = UINT64_MAX;
+        }
+        if (interp)
+            continue;
+        if (open_next == UINT64_MAX)
+            fprintf(out, "static int B_%08x(CPU* cpu) {\n", pc);
+
+        fprintf(out, "    // %#.8x\n", pc);
+        if (level >= LOG_TRACE)
+            fprintf(out, "    cpu_print_inst(&aot_insts[%u], cpu->pc);\n", k);
+        k++;
+        fprintf(out, "    cpu->pc += %u;\n    cpu->inst_retired++;\n", d->length);
+        if (needs_sample(p, off, d))
+            fprintf(out, "    cpu_sample_cycle(cpu, 0);\n");
+        else
+            fprintf(out, "    if (timer_sched_due(&cpu->timers, cpu->inst_retired))\n        cpu_sample_cycle(cpu, 0);\n");
+        emit_semantics(out, d);
+        fprintf(out, "    RETIRE();\n");
+
+        open_next = is_control(d->op) ? UINT64_MAX : (uint64_t)pc + d->length;
+        if (open_next == UINT64_MAX)
+            fprintf(out, "    return 1;\n}\n\n");
+    }
+    if (open_next != UINT64_MAX)
+        fprintf(out, "    return 1;\n}\n\n");
+}
+
+/*
+ * emit_run
+ * 作用：生成块入口表与 aot_run 分派循环。
+ * 行为：
+ *   - 入口表按 PC 索引块函数，没有块函数的 PC（ret 落点以外的非入口、镜像外、非法编码）由解释器单步执行；
+ *   - 每次返回分派后检查 PC 是否回到 0。
+ */
+static void emit_run(FILE* out, const AotProgram* p) {
+    fprintf(out, "typedef int (*aot_block_fn)(CPU* cpu);\n\n");
+    fprintf(out, "#define AOT_TABLE_SIZE %luu\n", (unsigned long)p->size);
+    fprintf(out, "static const aot_block_fn aot_blocks[AOT_TABLE_SIZE] = {\n");
+    uint64_t open_next = UINT64_MAX;
+    for (uint64_t off = 0; off < p->size; off++) {
+        if (!p->reach[off])
+            continue;
+        uint32_t pc = (uint32_t)(off + DRAM_BASE);
+        const DecodedInst* d = p->insts[off];
+        int interp = !d || needs_interp(d);
+        if (!interp && (open_next != pc || p->leader[off]))
+            fprintf(out, "    [0x%lx] = B_%08x,\n", (unsigned long)off, pc);
+        open_next = interp || is_control(d->op) ? UINT64_MAX : (uint64_t)pc + d->length;
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out,
+        "void aot_run(CPU* cpu) {\n"
+        "    while (1) {\n"
+        "        uint64_t off = (uint64_t)cpu->pc - DRAM_BASE;\n"
+        "        aot_block_fn fn = off < AOT_TABLE_SIZE ? aot_blocks[off] : NULL;\n"
+        "        if (fn) {\n"
+        "            if (!fn(cpu))\n"
+        "                return;\n"
+        "        } else {\n"
+        "            const DecodedInst* d = cpu_fetch_decoded(cpu);\n"
+        "            if (!cpu_execute_decoded(cpu, d))\n"
+        "                return;\n"
+        "            if (AOT_LOG_LEVEL >= LOG_FULL)\n"
+        "                dump_registers(cpu);\n"
+        "        }\n"
+        "        if (cpu->pc == 0)\n"
+        "            return;\n"
+        "    }\n"
+        "}\n");
+}
+
+int main(int argc, char* argv[]) {
+    static const struct option long_opts[] = {
+        { "log-level", required_argument, NULL, 'l' },
+        { "dram-size", required_argument, NULL, 's' },
+        { NULL, 0, NULL, 0 }
+    };
+    LOG_LEVEL level = LOG_FULL;
+    uint64_t dram_size = DRAM_DEFAULT_SIZE;
+    int opt;
+    while ((opt = getopt_long(argc, argv, "", long_opts, NULL)) != -1) {
+        int ok = opt == 'l' ? log_level_parse(optarg, &level)
+               : opt == 's' ? dram_parse_size(optarg, &dram_size) : 0;
+        if (!ok) {
+            printf("%sUsage: tsl_aot [--log-level=quiet|summary|trace|full] [--dram-size=N[K|M]|max] <image.bin> <out.c>%s\n", ANSI_RED, ANSI_RESET);
+            return 1;
+        }
+    }
+    if (argc - optind != 2) {
+        printf("%sUsage: tsl_aot [--log-level=quiet|summary|trace|full] [--dram-size=N[K|M]|max] <image.bin> <out.c>%s\n", ANSI_RED, ANSI_RESET);
+        return 1;
+    }
+    argv += optind - 1;
+
+    uint64_t size = 0;
+    uint8_t* image = read_image(argv[1], &size);
+    if (!image)
+        return 1;
+    if (size > dram_size) {
+        fprintf(stderr, "%s[aot] %s larger than DRAM, truncating to %lu bytes%s\n", ANSI_YELLOW, argv[1], (unsigned long)dram_size, ANSI_RESET);
+        size = dram_size;
+    }
+
+    // 遍历只覆盖镜像，镜像之外的 PC 由生成代码的分派退回解释器；DRAM 与运行时同样大小，
+    // 镜像末尾的指令按运行时相同的内容解码
+    // 只借用 CPU 的总线与解码缓存，不调用 cpu_init（不加载信息 DB）
+    AotProgram* p = (AotProgram*)calloc(1, sizeof(AotProgram));
+    p->size = size;
+    p->insts = (const DecodedInst**)calloc(p->size, sizeof(DecodedInst*));
+    p->reach = (uint8_t*)calloc(p->size, 1);
+    p->leader = (uint8_t*)calloc(p->size, 1);
+    if (!p->insts || !p->reach || !p->leader) {
+        fprintf(stderr, "%s[aot] out of memory%s\n", ANSI_RED, ANSI_RESET);
+        return 1;
+    }
+    if (!dram_init(&p->cpu.bus.dram, dram_size))
+        return 1;
+    for (uint64_t i = 0; i < size; i++)
+        dram_store_8(&p->cpu.bus.dram, i, image[i]);
+    cpu_init_caches(&p->cpu, p->size);
+
+    aot_walk(p);
+
+    FILE* out = fopen(argv[2], "w");
+    if (!out) {
+        fprintf(stderr, "%s[aot] unable to write %s%s\n", ANSI_RED, argv[2], ANSI_RESET);
+        return 1;
+    }
+    emit_prologue(out, argv[1], level, dram_size);
+    emit_image(out, image, size, argv[1]);
+    emit_inst_table(out, p);
+    emit_blocks(out, p, level);
+    emit_run(out, p);
+    fclose(out);
+
+    uint64_t n = 0;
+    for (uint64_t i = 0; i < p->size; i++) n += p->reach[i];
+    printf("[aot] %s -> %s (--log-level=%s): %lu reachable PCs\n", argv[1], argv[2], log_level_name(level), (unsigned long)n);
+
+    block_cache_free(&p->cpu.bcache);
+    decode_cache_free(&p->cpu.icache);
+    free(p->insts);
+    free(p->reach);
+    free(p->leader);
+    free(p);
+    free(image);
+    return 0;
+}
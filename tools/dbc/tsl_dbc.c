@@ -0,0 +1,41 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "color.h"
+#include "info_db.h"
+
+//=====================================================================================
+//   tsl_dbc：将 DB 目录下的文本 *.db 编译为 emulator 启动时直接映射的 info.tdb
+//=====================================================================================
+
+/*
+ * main（tsl_dbc）
+ * 作用：编译一个 DB 目录。
+ * 行为：
+ *   - 参数为 DB 目录或其中的 .bin 镜像（与 emulator 相同，取其所在目录）；
+ *   - 默认写到该目录下的 info.tdb，文本 *.db 更新后需重新编译，否则 emulator 回退到文本解析。
+ * 示例：
+ *   tsl_dbc examples/signal_action => examples/signal_action/info.tdb
+ */
+int main(int argc, char* argv[]) {
+    if (argc != 2 && argc != 3) {
+        printf("%sUsage: tsl_dbc <db_dir|image.bin> [out.tdb]%s\n", ANSI_RED, ANSI_RESET);
+        return 1;
+    }
+
+    size_t len = strlen(argv[1]);
+    char base[1024];
+    if (len > 4 && strcmp(argv[1] + len - 4, ".bin") == 0)
+        snprintf(base, sizeof(base), "%s", strchr(argv[1], '/') ? argv[1] : "./");
+    else
+        snprintf(base, sizeof(base), "%s%s", argv[1], len && argv[1][len - 1] == '/' ? "" : "/");
+    set_info_base(base);
+
+    char out[1100];
+    if (argc == 3)
+        snprintf(out, sizeof(out), "%s", argv[2]);
+    else
+        snprintf(out, sizeof(out), "%.*s%s", (int)(strrchr(base, '/') - base + 1), base, INFO_DB_FILE);
+    return info_db_compile(out) ? 0 : 1;
+}
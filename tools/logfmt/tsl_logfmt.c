@@ -0,0 +1,60 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "cpu.h"
+#include "color.h"
+#include "log.h"
+
+//=====================================================================================
+//   tsl_logfmt：将 emulator --log-deferred 写出的事件文件格式化为与直接运行相同的 stdout 文本
+//=====================================================================================
+
+/*
+ * main（tsl_logfmt）
+ * 作用：逐条读取延迟格式化事件并输出文本。
+ * 行为：
+ *   - 校验文件头；
+ *   - TEXT 事件原样输出，其余事件按事件号与原始参数调用 cpu_render_event；
+ *   - 文件截断（运行异常终止）时输出已完整写入的部分后结束。
+ * 示例：
+ *   emulator --log-deferred=run.logd test.bin && tsl_logfmt run.logd => 与 emulator test.bin 的输出一致
+ */
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        printf("%sUsage: tsl_logfmt <run.logd>%s\n", ANSI_RED, ANSI_RESET);
+        return 1;
+    }
+
+    FILE* in = fopen(argv[1], "rb");
+    if (!in) {
+        fprintf(stderr, "%s[logfmt] unable to open %s%s\n", ANSI_RED, argv[1], ANSI_RESET);
+        return 1;
+    }
+    LogDeferredHeader h;
+    if (fread(&h, sizeof(h), 1, in) != 1 || memcmp(h.magic, LOG_DEFERRED_MAGIC, sizeof(LOG_DEFERRED_MAGIC)) != 0
+        || h.version != LOG_DEFERRED_VERSION) {
+        fprintf(stderr, "%s[logfmt] %s is not a version %d deferred log%s\n", ANSI_RED, argv[1], LOG_DEFERRED_VERSION, ANSI_RESET);
+        fclose(in);
+        return 1;
+    }
+
+    // TEXT 最长 0xFFFF 字节，其余事件参数远小于此
+    static uint32_t payload[0x10000 / sizeof(uint32_t)];
+    LogEventHdr e;
+    while (fread(&e, sizeof(e), 1, in) == 1) {
+        size_t bytes = e.ev == LOG_EV_TEXT ? e.n : (size_t)e.n * sizeof(uint32_t);
+        if (bytes > sizeof(payload) || fread(payload, 1, bytes, in) != bytes)
+            break;
+        if (e.ev == LOG_EV_TEXT) {
+            fwrite(payload, 1, bytes, stdout);
+        } else if (!cpu_render_event(e.ev, payload)) {
+            fprintf(stderr, "%s[logfmt] unknown event %u%s\n", ANSI_RED, e.ev, ANSI_RESET);
+            break;
+        }
+    }
+
+    fclose(in);
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "cpu.h"
+#include "color.h"
+#include "info_db.h"
+#include "trace.h"
+
+//=====================================================================================
+//   tsl_trace：将 emulator --trace-file 写出的二进制轨迹还原为 full 级别的逐条文本
+//=====================================================================================
+
+/*
+ * render_effects
+ * 作用：输出指令执行时自身打印的内容（与 exec_* 一致）。
+ * 行为：
+ *   - load 打印取到的信号值（记录中的目标寄存器新值），并记入重建的信号索引；
+ *   - send/domain_set 按 *.db 查询并打印，display 代入信号索引中的值（无波形激励时与运行时一致，
+ *     有波形激励时为该地址最近一次 load 的值）；trigger/trigger_pos 打印触发信息。
+ */
+static void render_effects(const DecodedInst* d, const TraceRecord* r) {
+    switch (d->op) {
+        case INST_OP_LOAD:
+            printf("%sGet signal var from addr[0x%x] = 0x%x%s\n", ANSI_BOLD_GREEN, d->imm, r->value, ANSI_RESET);
+            set_signal_value(d->imm, r->value);
+            break;
+        case INST_OP_TRIGGER_POS:
+            printf("%sTrigger sample pos set %u%%!%s\n", ANSI_BOLD_GREEN, d->imm, ANSI_RESET);
+            break;
+        case INST_OP_TRIGGER:
+            printf("%sTime stop! Start trigger signal sample!%s\n", ANSI_BOLD_GREEN, ANSI_RESET);
+            break;
+        case INST_OP_DOMAIN_SET: {
+            char* info = get_domain_info((uint8_t)d->imm);
+            if (info)
+                printf("%sdomain(%s)%s\n", ANSI_BOLD_GREEN, info, ANSI_RESET);
+            else
+                fprintf(stderr, "%s[cpu][db] domain not found: %u!%s\n", ANSI_RED, (uint8_t)d->imm, ANSI_RESET);
+            break;
+        }
+        case INST_OP_SEND_DISPLAY: case INST_OP_SEND_EXEC: case INST_OP_SEND_UNKNOWN: {
+            size_t n;
+            const char* line = builtin_send_line(d->imm, d->func, &n);
+            fwrite(line, 1, n, stdout);
+            if (d->op == INST_OP_SEND_UNKNOWN)
+                fprintf(stderr, "%s[cpu][send] unknown func: 0x%x%s\n", ANSI_RED, d->func, ANSI_RESET);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+/*
+ * replay_record
+ * 作用：按一条记录输出文本并更新重建的寄存器状态。
+ * 行为：
+ *   - 打印地址与反汇编、执行输出；
+ *   - 写回目标寄存器，timer_set cfg_enable 更新阈值与目标 PC，定时器按记录恢复使能与计数；
+ *   - 使能的定时器执行后计数为 0 即本条 tick 到期，打印与 timer_tick_and_jump 相同的信息；
+ *   - 打印寄存器。
+ */
+static void replay_record(CPU* cpu, const TraceRecord* r) {
+    DecodedInst d;
+    cpu_decode(r->raw, r->length, &d);
+
+    cpu_print_inst(&d, r->pc);
+    render_effects(&d, r);
+
+    if (r->reg < 16)
+        cpu->regs[r->reg] = r->value;
+    else if (r->reg == TRACE_REG_RET)
+        cpu->ret_reg = r->value;
+    cpu->inst_retired++;
+    if (d.op == INST_OP_TIMER_CFG_ENABLE)
+        timer_sched_config(&cpu->timers, d.rd, cpu->inst_retired, d.imm, r->pc + r->length + d.offset);
+    for (int id = 0; id < 2; id++) {
+        int enabled = (r->flags & (id ? TRACE_F_T1_EN : TRACE_F_T0_EN)) != 0;
+        timer_sched_restore(&cpu->timers, id, cpu->inst_retired, enabled, r->timer[id]);
+        if (!enabled || r->timer[id] != 0)
+            continue;
+        const TIMER* t = &cpu->timers.timers[id];
+        if (t->target_pc)
+            printf("%sTimer %d reached %" PRIu64 ", jump -> %#.8x%s\n", ANSI_BOLD_GREEN, id, t->threshold, t->target_pc, ANSI_RESET);
+        else
+            printf("%s[cpu][timer] threshold reached (id=%d) but no target%s\n", ANSI_BOLD_RED, id, ANSI_RESET);
+    }
+    cpu->pc = r->next_pc;
+
+    dump_registers(cpu);
+}
+
+/*
+ * main（tsl_trace）
+ * 作用：解码二进制轨迹文件。
+ * 行为：
+ *   - 校验文件头，按记录中的镜像路径（或命令行指定的 .bin）定位 *.db；
+ *   - 按块读取记录逐条还原，输出与 emulator 默认（full）级别下的逐条指令输出一致。
+ * 示例：
+ *   emulator --trace-file=run.trc test.bin && tsl_trace run.trc => 逐条指令的反汇编与寄存器
+ */
+int main(int argc, char* argv[]) {
+    if (argc != 2 && argc != 3) {
+        printf("%sUsage: tsl_trace <trace.trc> [image.bin]%s\n", ANSI_RED, ANSI_RESET);
+        return 1;
+    }
+
+    FILE* in = fopen(argv[1], "rb");
+    if (!in) {
+        fprintf(stderr, "%s[trace] unable to open %s%s\n", ANSI_RED, argv[1], ANSI_RESET);
+        return 1;
+    }
+    TraceHeader h;
+    if (fread(&h, sizeof(h), 1, in) != 1 || memcmp(h.magic, TRACE_MAGIC, sizeof(h.magic)) != 0
+        || h.version != TRACE_VERSION || h.record_size != sizeof(TraceRecord)) {
+        fprintf(stderr, "%s[trace] %s is not a version %d trace file%s\n", ANSI_RED, argv[1], TRACE_VERSION, ANSI_RESET);
+        fclose(in);
+        return 1;
+    }
+    h.image[sizeof(h.image) - 1] = '\0';
+
+    set_info_base(argc == 3 ? argv[2] : h.image);
+    init_builtin_info_table();
+    init_domain_info_table();
+    init_signal_index();
+
+    CPU* cpu = (CPU*)calloc(1, sizeof(CPU));
+    timer_sched_init(&cpu->timers, CPU_TIMER_COUNT);
+    TraceRecord* buf = (TraceRecord*)malloc((size_t)TRACE_BUF_RECORDS * sizeof(TraceRecord));
+    size_t n;
+    while ((n = fread(buf, sizeof(TraceRecord), TRACE_BUF_RECORDS, in)) > 0) {
+        for (size_t i = 0; i < n; i++)
+            replay_record(cpu, &buf[i]);
+    }
+
+    free(buf);
+    timer_sched_free(&cpu->timers);
+    free(cpu);
+    fclose(in);
+    free_builtin_info_table();
+    free_domain_info_table();
+    free_signal_index();
+    return 0;
+}